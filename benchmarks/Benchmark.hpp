@@ -0,0 +1,310 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+namespace envire { namespace benchmark
+{
+
+/**Result of one benchmark case. All times are per operation. */
+struct Result
+{
+    std::string name;
+    /**Size of the input, e.g. the number of frames */
+    size_t size;
+    size_t iterations;
+    double minNs;
+    double medianNs;
+    double meanNs;
+    /**Latency percentiles of single operations, zero if not recorded (see Suite::runLatency()) */
+    double p90Ns;
+    double p99Ns;
+    double maxNs;
+    /**Processed items and bytes per operation, zero if not reported */
+    double items;
+    double bytes;
+    /**Heap allocations per operation, negative if not counted */
+    double allocations;
+    /**Peak resident set size of the process after the case */
+    size_t peakRssBytes;
+
+    double itemsPerSecond() const { return items * 1e9 / medianNs; }
+    double megabytesPerSecond() const { return bytes * 1e3 / medianNs; }
+};
+
+/** @return the peak resident set size of the process in bytes */
+inline size_t peakResidentBytes()
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; //ru_maxrss is in kilobytes on linux
+}
+
+/**Prevents the compiler from optimizing away the computation of @p value */
+template <class T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**Collects the results of several benchmark cases.
+ * The results are printed as table while running and can be written as
+ * JSON to track them over time.
+ *
+ * Each case is repeated @p repetitions times. A repetition calls the
+ * measured function @p iterations times, the time per operation of a
+ * repetition is the duration divided by the iterations. */
+class Suite
+{
+public:
+    /**Returns the number of heap allocations of the process so far */
+    typedef std::function<size_t ()> AllocationCounter;
+
+    Suite(const std::string& name, const size_t repetitions = 5)
+        : name(name), repetitions(repetitions)
+    {
+        std::cout << std::setw(40) << std::left << "benchmark" << std::right
+                  << std::setw(10) << "size"
+                  << std::setw(12) << "iterations"
+                  << std::setw(14) << "min [ns]"
+                  << std::setw(14) << "median [ns]"
+                  << std::setw(14) << "mean [ns]"
+                  << std::setw(14) << "items/s"
+                  << std::setw(12) << "MB/s" << std::endl;
+    }
+
+    /**Enables counting the allocations of the measured functions.
+     * The benchmark has to provide the counter, e.g. by replacing operator new. */
+    void setAllocationCounter(const AllocationCounter& counter)
+    {
+        allocationCounter = counter;
+    }
+
+    /**Measures @p func which is called with the index of the iteration.
+     * @param setup is called before each repetition and is not measured */
+    template <class SETUP, class FUNC>
+    const Result& run(const std::string& caseName, const size_t size,
+                      const size_t iterations, SETUP setup, FUNC func)
+    {
+        return runThroughput(caseName, size, iterations, 0, 0, setup, func);
+    }
+
+    /**Measures @p func without setup */
+    template <class FUNC>
+    const Result& run(const std::string& caseName, const size_t size,
+                      const size_t iterations, FUNC func)
+    {
+        return run(caseName, size, iterations, [](){}, func);
+    }
+
+    /**Measures @p func and additionally reports the throughput.
+     * @param items number of items that are processed by one call of @p func
+     * @param bytes number of bytes that are processed by one call of @p func */
+    template <class SETUP, class FUNC>
+    const Result& runThroughput(const std::string& caseName, const size_t size,
+                                const size_t iterations, const double items,
+                                const double bytes, SETUP setup, FUNC func)
+    {
+        std::vector<double> times;
+        times.reserve(repetitions);
+        size_t allocations = 0;
+        for(size_t r = 0; r < repetitions; ++r)
+        {
+            setup();
+            const size_t allocationsBefore = countAllocations();
+            const auto start = std::chrono::steady_clock::now();
+            for(size_t i = 0; i < iterations; ++i)
+                func(i);
+            const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+            allocations += countAllocations() - allocationsBefore;
+            times.push_back(duration.count() / iterations);
+        }
+        Result result = makeResult(caseName, size, iterations, times);
+        result.items = items;
+        result.bytes = bytes;
+        result.allocations = allocationCounter ? double(allocations) / (repetitions * iterations) : -1;
+        return report(result);
+    }
+
+    /**Measures each call of @p func separately to get the latency distribution.
+     * Use this for operations that take considerably longer than reading the clock. */
+    template <class SETUP, class FUNC>
+    const Result& runLatency(const std::string& caseName, const size_t size,
+                             const size_t iterations, SETUP setup, FUNC func)
+    {
+        std::vector<double> times;
+        times.reserve(repetitions * iterations);
+        size_t allocations = 0;
+        for(size_t r = 0; r < repetitions; ++r)
+        {
+            setup();
+            const size_t allocationsBefore = countAllocations();
+            for(size_t i = 0; i < iterations; ++i)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                func(i);
+                const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+                times.push_back(duration.count());
+            }
+            allocations += countAllocations() - allocationsBefore;
+        }
+        Result result = makeResult(caseName, size, iterations, times);
+        result.p90Ns = percentile(times, 0.90);
+        result.p99Ns = percentile(times, 0.99);
+        result.maxNs = times.back();
+        result.allocations = allocationCounter ? double(allocations) / (repetitions * iterations) : -1;
+        return report(result);
+    }
+
+    const std::vector<Result>& getResults() const { return results; }
+
+    /**Writes the results as JSON to @p stream */
+    void writeJson(std::ostream& stream) const
+    {
+        stream << "{\n  \"suite\": \"" << name << "\",\n  \"results\": [\n";
+        for(size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            stream << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+                   << ", \"iterations\": " << r.iterations
+                   << std::fixed << std::setprecision(3)
+                   << ", \"min_ns\": " << r.minNs
+                   << ", \"median_ns\": " << r.medianNs
+                   << ", \"mean_ns\": " << r.meanNs;
+            if(r.maxNs > 0)
+                stream << ", \"p90_ns\": " << r.p90Ns
+                       << ", \"p99_ns\": " << r.p99Ns
+                       << ", \"max_ns\": " << r.maxNs;
+            if(r.items > 0)
+                stream << ", \"items_per_s\": " << r.itemsPerSecond();
+            if(r.bytes > 0)
+                stream << ", \"mb_per_s\": " << r.megabytesPerSecond();
+            if(r.allocations >= 0)
+                stream << ", \"allocations\": " << r.allocations;
+            stream << ", \"peak_rss_bytes\": " << r.peakRssBytes << "}"
+                   << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        stream << "  ]\n}\n";
+    }
+
+    /**Writes the results as JSON to @p fileName.
+     * @return false if the file could not be opened */
+    bool writeJson(const std::string& fileName) const
+    {
+        std::ofstream file(fileName);
+        if(!file.is_open())
+        {
+            std::cerr << "Could not open " << fileName << std::endl;
+            return false;
+        }
+        writeJson(file);
+        std::cout << "results written to " << fileName << std::endl;
+        return true;
+    }
+
+private:
+    size_t countAllocations() const
+    {
+        return allocationCounter ? allocationCounter() : 0;
+    }
+
+    /** @param sorted ascending sorted samples */
+    static double percentile(const std::vector<double>& sorted, const double p)
+    {
+        return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+    }
+
+    /**Sorts @p times and fills the timing statistics */
+    Result makeResult(const std::string& caseName, const size_t size,
+                      const size_t iterations, std::vector<double>& times) const
+    {
+        std::sort(times.begin(), times.end());
+        Result result = Result();
+        result.name = caseName;
+        result.size = size;
+        result.iterations = iterations;
+        result.minNs = times.front();
+        result.medianNs = percentile(times, 0.5);
+        double sum = 0;
+        for(const double t : times)
+            sum += t;
+        result.meanNs = sum / times.size();
+        result.allocations = -1;
+        result.peakRssBytes = peakResidentBytes();
+        return result;
+    }
+
+    const Result& report(const Result& result)
+    {
+        results.push_back(result);
+        std::cout << std::setw(40) << std::left << result.name << std::right
+                  << std::setw(10) << result.size
+                  << std::setw(12) << result.iterations
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << result.minNs
+                  << std::setw(14) << result.medianNs
+                  << std::setw(14) << result.meanNs;
+        if(result.items > 0)
+            std::cout << std::setw(14) << std::setprecision(0) << result.itemsPerSecond();
+        else
+            std::cout << std::setw(14) << "-";
+        if(result.bytes > 0)
+            std::cout << std::setw(12) << std::setprecision(2) << result.megabytesPerSecond();
+        else
+            std::cout << std::setw(12) << "-";
+        std::cout << std::endl;
+        if(result.maxNs > 0 || result.allocations >= 0)
+        {
+            std::cout << std::setw(40) << "" << std::setprecision(1);
+            if(result.maxNs > 0)
+                std::cout << "  p90 " << result.p90Ns << " ns, p99 " << result.p99Ns
+                          << " ns, max " << result.maxNs << " ns";
+            if(result.allocations >= 0)
+                std::cout << "  allocations/op " << std::setprecision(2) << result.allocations;
+            std::cout << std::endl;
+        }
+        return results.back();
+    }
+
+    std::string name;
+    size_t repetitions;
+    std::vector<Result> results;
+    AllocationCounter allocationCounter;
+};
+
+}}
@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <envire_core/items/ItemBase.hpp>
+#include <envire_core/items/Transform.hpp>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace envire { namespace benchmark
+{
+
+/**Synthetic graph topology used by the benchmarks.
+ * The edges are stored as indices into @c frames. The tree edges form a
+ * spanning tree rooted at frames[0], cross edges close cycles. */
+struct GraphTopology
+{
+    typedef std::pair<size_t, size_t> Edge;
+
+    std::vector<envire::core::FrameId> frames;
+    std::vector<Edge> treeEdges;
+    std::vector<Edge> crossEdges;
+
+    /**The frame that is the farthest away from the root */
+    size_t deepestFrame = 0;
+};
+
+namespace detail
+{
+    inline void addFrames(GraphTopology& topology, const size_t numFrames)
+    {
+        topology.frames.reserve(numFrames);
+        for(size_t i = 0; i < numFrames; ++i)
+            topology.frames.push_back("frame_" + std::to_string(i));
+    }
+}
+
+/**0 -> 1 -> 2 -> ... -> n-1 */
+inline GraphTopology makeChain(const size_t numFrames)
+{
+    GraphTopology topology;
+    detail::addFrames(topology, numFrames);
+    for(size_t i = 1; i < numFrames; ++i)
+        topology.treeEdges.emplace_back(i - 1, i);
+    topology.deepestFrame = numFrames - 1;
+    return topology;
+}
+
+/**All frames are connected to frame 0 */
+inline GraphTopology makeStar(const size_t numFrames)
+{
+    GraphTopology topology;
+    detail::addFrames(topology, numFrames);
+    for(size_t i = 1; i < numFrames; ++i)
+        topology.treeEdges.emplace_back(0, i);
+    topology.deepestFrame = numFrames - 1;
+    return topology;
+}
+
+/**Balanced tree in heap order, i.e. the parent of i is (i - 1) / branching */
+inline GraphTopology makeBalancedTree(const size_t numFrames, const size_t branching = 2)
+{
+    GraphTopology topology;
+    detail::addFrames(topology, numFrames);
+    for(size_t i = 1; i < numFrames; ++i)
+        topology.treeEdges.emplace_back((i - 1) / branching, i);
+    topology.deepestFrame = numFrames - 1;
+    return topology;
+}
+
+/**Random tree where the parent of i is chosen uniformly from [0, i).
+ * Additionally @p numCrossEdges random edges between unconnected frames are added.
+ * The generator is seeded with @p seed to get reproducible graphs. */
+inline GraphTopology makeRandomTree(const size_t numFrames, const size_t numCrossEdges,
+                                    const unsigned seed = 42)
+{
+    GraphTopology topology;
+    detail::addFrames(topology, numFrames);
+    std::mt19937 rng(seed);
+    std::vector<size_t> depth(numFrames, 0);
+    std::vector<size_t> parent(numFrames, 0);
+    for(size_t i = 1; i < numFrames; ++i)
+    {
+        parent[i] = std::uniform_int_distribution<size_t>(0, i - 1)(rng);
+        depth[i] = depth[parent[i]] + 1;
+        topology.treeEdges.emplace_back(parent[i], i);
+        if(depth[i] > depth[topology.deepestFrame])
+            topology.deepestFrame = i;
+    }
+    if(numFrames < 3)
+        return topology;
+
+    std::uniform_int_distribution<size_t> frameDist(0, numFrames - 1);
+    std::set<GraphTopology::Edge> used;
+    while(topology.crossEdges.size() < numCrossEdges)
+    {
+        const size_t a = frameDist(rng);
+        const size_t b = frameDist(rng);
+        //skip self loops, tree edges and duplicates
+        if(a == b || parent[a] == b || parent[b] == a)
+            continue;
+        const GraphTopology::Edge edge(std::min(a, b), std::max(a, b));
+        if(!used.insert(edge).second)
+            continue;
+        topology.crossEdges.push_back(edge);
+    }
+    return topology;
+}
+
+/**A transform with a small translation, so that chained transforms don't degenerate */
+inline envire::core::Transform makeTransform(const size_t i)
+{
+    return envire::core::Transform(base::Position(0.1 * (i % 7), 0.2, 0.0),
+                                   base::Orientation(Eigen::AngleAxisd(0.01 * (i % 13), Eigen::Vector3d::UnitZ())));
+}
+
+/**Adds all frames and edges of @p topology to @p graph */
+template <class GRAPH>
+void buildGraph(GRAPH& graph, const GraphTopology& topology, const bool withCrossEdges = true)
+{
+    for(const envire::core::FrameId& frame : topology.frames)
+        graph.addFrame(frame);
+    size_t i = 0;
+    for(const GraphTopology::Edge& edge : topology.treeEdges)
+        graph.addTransform(topology.frames[edge.first], topology.frames[edge.second], makeTransform(i++));
+    if(!withCrossEdges)
+        return;
+    for(const GraphTopology::Edge& edge : topology.crossEdges)
+        graph.addTransform(topology.frames[edge.first], topology.frames[edge.second], makeTransform(i++));
+}
+
+}}
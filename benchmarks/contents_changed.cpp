@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Compares the memory footprint and the notification latency of the
+ * lightweight contents changed callbacks of ItemBase with the
+ * boost::signals2::signal that was used before. */
+
+#include <envire_core/items/Item.hpp>
+#include <boost/signals2.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+
+using namespace envire::core;
+
+namespace
+{
+    /**Mimics the previous Item<int>, which embedded a signal instead of
+     * the callback list. Overestimates the previous size by the unused
+     * callback list pointer. */
+    struct SignalItem : public Item<int>
+    {
+        boost::signals2::signal<void (SignalItem& item)> itemContentsChanged;
+        void signalContentsChanged() { itemContentsChanged(*this); }
+    };
+
+    /** @return the resident set size in bytes (linux only) */
+    size_t residentBytes()
+    {
+        size_t pages = 0, resident = 0;
+        std::ifstream statm("/proc/self/statm");
+        statm >> pages >> resident;
+        return resident * sysconf(_SC_PAGESIZE);
+    }
+
+    template <class FUNC>
+    double measureNs(const size_t count, FUNC func)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < count; ++i)
+            func(i);
+        const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+        return duration.count() / count;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t numItems = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    size_t counter = 0;
+
+    std::cout << "items: " << numItems << std::endl;
+    std::cout << "sizeof(Item<int>): " << sizeof(Item<int>) << " bytes" << std::endl;
+    std::cout << "sizeof(Item<int> with signals2::signal): " << sizeof(SignalItem)
+              << " bytes + heap allocated state" << std::endl;
+
+    size_t rss = residentBytes();
+    std::vector<Item<int>> items(numItems);
+    std::cout << "memory per item [bytes]: callbacks " << double(residentBytes() - rss) / numItems;
+    rss = residentBytes();
+    std::vector<SignalItem> signalItems(numItems);
+    std::cout << ", signals2 " << double(residentBytes() - rss) / numItems << std::endl;
+
+    std::cout << "contentsChanged() without callbacks [ns]:  callbacks "
+              << measureNs(numItems, [&](size_t i) { items[i].contentsChanged(); })
+              << ", signals2 "
+              << measureNs(numItems, [&](size_t i) { signalItems[i].signalContentsChanged(); }) << std::endl;
+
+    for(size_t i = 0; i < numItems; ++i)
+    {
+        items[i].connectContentsChangedCallback([&counter](ItemBase&) { ++counter; });
+        signalItems[i].itemContentsChanged.connect([&counter](SignalItem&) { ++counter; });
+    }
+
+    std::cout << "contentsChanged() with one callback [ns]:  callbacks "
+              << measureNs(numItems, [&](size_t i) { items[i].contentsChanged(); })
+              << ", signals2 "
+              << measureNs(numItems, [&](size_t i) { signalItems[i].signalContentsChanged(); }) << std::endl;
+    std::cout << "calls: " << counter << std::endl;
+    return 0;
+}
@@ -0,0 +1,351 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Measures the fanout latency of graph events depending on the number of
+ * subscribers (1 to 10k) and the event mix (edge, frame and item events).
+ * Covers GraphEventPublisher::notify with GraphEventDispatcher and
+ * GraphItemEventDispatcher subscribers, GraphEventQueue bursts (with and
+ * without merging), auto updating Paths of an EnvireGraph and
+ * subscribing with the current state of the graph.
+ * Heap allocations per event are counted by replacing operator new.
+ *
+ * usage: benchmark_event_throughput [max_subscribers] [json_file] */
+
+#include "Benchmark.hpp"
+#include "GraphGenerators.hpp"
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <envire_core/events/GraphItemEventDispatcher.hpp>
+#include <envire_core/events/GraphEventQueue.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <envire_core/events/FrameEvents.hpp>
+#include <envire_core/events/ItemAddedEvent.hpp>
+#include <envire_core/events/ItemRemovedEvent.hpp>
+#include <envire_core/events/ItemModifiedEvent.hpp>
+#include <envire_core/items/Item.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+using namespace envire::core;
+using namespace envire::benchmark;
+
+namespace
+{
+    std::atomic<size_t> allocationCount(0);
+}
+
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if(void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    typedef std::vector<std::unique_ptr<GraphEvent>> EventList;
+
+    /**Publisher without a graph, to measure the fanout only */
+    class Publisher : public GraphEventPublisher
+    {
+    public:
+        using GraphEventPublisher::notify;
+    protected:
+        virtual void publishCurrentState(GraphEventSubscriber*) override {}
+        virtual void unpublishCurrentState(GraphEventSubscriber*) override {}
+    };
+
+    class CountingDispatcher : public GraphEventDispatcher
+    {
+    public:
+        size_t count = 0;
+    protected:
+        virtual void edgeAdded(const EdgeAddedEvent&) override { ++count; }
+        virtual void edgeRemoved(const EdgeRemovedEvent&) override { ++count; }
+        virtual void edgeModified(const EdgeModifiedEvent&) override { ++count; }
+        virtual void frameAdded(const FrameAddedEvent&) override { ++count; }
+        virtual void frameRemoved(const FrameRemovedEvent&) override { ++count; }
+        virtual void itemAdded(const ItemAddedEvent&) override { ++count; }
+        virtual void itemRemoved(const ItemRemovedEvent&) override { ++count; }
+        virtual void itemModified(const ItemModifiedEvent&) override { ++count; }
+    };
+
+    class CountingItemDispatcher : public GraphItemEventDispatcher<Item<int>>
+    {
+    public:
+        size_t count = 0;
+    protected:
+        virtual void itemAdded(const TypedItemAddedEvent<Item<int>>&) override { ++count; }
+        virtual void itemRemoved(const TypedItemRemovedEvent<Item<int>>&) override { ++count; }
+        virtual void itemModified(const TypedItemModifiedEvent<Item<int>>&) override { ++count; }
+    };
+
+    class CountingQueue : public GraphEventQueue
+    {
+    public:
+        size_t count = 0;
+        virtual void process(const GraphEvent&) override { ++count; }
+    };
+
+    void addEdgeEvents(EventList& events, const FrameId& origin, const FrameId& target)
+    {
+        events.emplace_back(new EdgeAddedEvent(origin, target, GraphTraits::edge_descriptor()));
+        events.emplace_back(new EdgeModifiedEvent(origin, target, GraphTraits::edge_descriptor(), GraphTraits::edge_descriptor()));
+        events.emplace_back(new EdgeRemovedEvent(origin, target));
+    }
+
+    void addFrameEvents(EventList& events, const FrameId& frame)
+    {
+        events.emplace_back(new FrameAddedEvent(frame));
+        events.emplace_back(new FrameRemovedEvent(frame));
+    }
+
+    void addItemEvents(EventList& events, const FrameId& frame)
+    {
+        const ItemBase::Ptr item(new Item<int>(42));
+        events.emplace_back(new ItemAddedEvent(frame, item));
+        events.emplace_back(new ItemModifiedEvent(frame, item));
+        events.emplace_back(new ItemRemovedEvent(frame, item));
+    }
+
+    /**@return a repeating sequence of events of the given mix.
+     * @param count number of distinct frames used by the events */
+    EventList makeEvents(const std::string& mix, const size_t count)
+    {
+        EventList events;
+        for(size_t i = 0; i < count; ++i)
+        {
+            const FrameId frame = "frame_" + std::to_string(i);
+            const FrameId other = "other_" + std::to_string(i);
+            if(mix == "edge" || mix == "mixed")
+                addEdgeEvents(events, frame, other);
+            if(mix == "frame" || mix == "mixed")
+                addFrameEvents(events, frame);
+            if(mix == "item" || mix == "mixed")
+                addItemEvents(events, frame);
+        }
+        return events;
+    }
+
+    /**Events that can be queued without being merged, i.e. only additions of different frames */
+    EventList makeUnmergeableEvents(const size_t count)
+    {
+        EventList events;
+        for(size_t i = 0; i < count; ++i)
+        {
+            const FrameId frame = "frame_" + std::to_string(i);
+            switch(i % 3)
+            {
+                case 0:
+                    events.emplace_back(new FrameAddedEvent(frame));
+                    break;
+                case 1:
+                    events.emplace_back(new EdgeAddedEvent(frame, "root", GraphTraits::edge_descriptor()));
+                    break;
+                default:
+                    events.emplace_back(new ItemAddedEvent(frame, ItemBase::Ptr(new Item<int>(42))));
+                    break;
+            }
+        }
+        return events;
+    }
+
+    size_t fanoutIterations(const size_t subscribers)
+    {
+        return std::max<size_t>(100, 1000000 / subscribers);
+    }
+
+    template <class SUBSCRIBER>
+    void benchmarkFanout(Suite& suite, const std::string& name, const size_t maxSubscribers)
+    {
+        for(const std::string mix : {"edge", "frame", "item", "mixed"})
+        {
+            const EventList events = makeEvents(mix, 16);
+            for(size_t n = 1; n <= maxSubscribers; n *= 10)
+            {
+                Publisher publisher;
+                std::vector<std::unique_ptr<SUBSCRIBER>> subscribers;
+                for(size_t i = 0; i < n; ++i)
+                {
+                    subscribers.emplace_back(new SUBSCRIBER());
+                    subscribers.back()->subscribe(&publisher);
+                }
+                suite.runLatency("fanout/" + name + "/" + mix, n, fanoutIterations(n), [](){},
+                                 [&](size_t i) { publisher.notify(*events[i % events.size()]); });
+                subscribers.clear();
+            }
+        }
+    }
+
+    void benchmarkQueue(Suite& suite, const size_t maxBurst)
+    {
+        for(size_t burst = 1; burst <= maxBurst; burst *= 10)
+        {
+            const size_t iterations = std::max<size_t>(5, 10000 / burst);
+            Publisher publisher;
+            CountingQueue queue;
+            queue.subscribe(&publisher);
+
+            //every event is queued, the merge check has to compare it to all queued events
+            const EventList unmergeable = makeUnmergeableEvents(burst);
+            suite.runLatency("queue/burst_flush", burst, iterations, [](){},
+                             [&](size_t)
+                             {
+                                 for(const auto& event : unmergeable)
+                                     publisher.notify(*event);
+                                 queue.flush();
+                             });
+
+            //added and removed frames cancel each other out
+            EventList mergeable;
+            for(size_t i = 0; i < burst; ++i)
+                addFrameEvents(mergeable, "frame_" + std::to_string(i));
+            suite.runLatency("queue/burst_merge_flush", burst, iterations, [](){},
+                             [&](size_t)
+                             {
+                                 for(const auto& event : mergeable)
+                                     publisher.notify(*event);
+                                 queue.flush();
+                             });
+        }
+    }
+
+    /**Auto updating paths are registered in the PathRegistry of the graph.
+     * Edge removals only reach the paths that contain the removed edge */
+    void benchmarkPathSubscribers(Suite& suite, const size_t maxSubscribers)
+    {
+        const GraphTopology topology = makeRandomTree(100, 10);
+        for(size_t n = 1; n <= maxSubscribers; n *= 10)
+        {
+            EnvireGraph graph;
+            buildGraph(graph, topology);
+            std::vector<Path::Ptr> paths;
+            for(size_t i = 0; i < n; ++i)
+            {
+                const FrameId& origin = topology.frames[(7 * i) % topology.frames.size()];
+                const FrameId& target = topology.frames[(13 * i + 1) % topology.frames.size()];
+                paths.push_back(graph.getPath(origin, target, true));
+            }
+
+            const FrameId& leaf = topology.frames[topology.deepestFrame];
+            const GraphTopology::Edge& edge = topology.treeEdges.front();
+            const FrameId& origin = topology.frames[edge.first];
+            const FrameId& target = topology.frames[edge.second];
+            const size_t iterations = fanoutIterations(n);
+            suite.runLatency("path_subscribers/updateTransform", n, iterations, [](){},
+                             [&](size_t i) { graph.updateTransform(origin, target, makeTransform(i)); });
+            suite.runLatency("path_subscribers/add_remove_edge", n, iterations,
+                             [&]()
+                             {
+                                 if(graph.containsFrame("extra_frame") && graph.containsEdge(leaf, "extra_frame"))
+                                     graph.removeTransform(leaf, "extra_frame");
+                             },
+                             [&](size_t i)
+                             {
+                                 if(i % 2 == 0)
+                                     graph.addTransform(leaf, "extra_frame", makeTransform(i));
+                                 else
+                                     graph.removeTransform(leaf, "extra_frame");
+                             });
+            std::vector<ItemBase::Ptr> items;
+            for(size_t i = 0; i < iterations; ++i)
+                items.emplace_back(new Item<int>(int(i)));
+            suite.runLatency("path_subscribers/addItemToFrame", n, iterations,
+                             [&]() { graph.clearFrame(leaf); },
+                             [&](size_t i) { graph.addItemToFrame(leaf, items[i]); });
+            graph.clearFrame(leaf);
+            paths.clear();
+        }
+    }
+
+    /**Subscribing with publish_current_state replays the whole graph to the subscriber */
+    void benchmarkCurrentState(Suite& suite, const size_t maxFrames)
+    {
+        for(size_t n = 10; n <= maxFrames; n *= 10)
+        {
+            const GraphTopology topology = makeBalancedTree(n);
+            EnvireGraph graph;
+            buildGraph(graph, topology);
+            for(const FrameId& frame : topology.frames)
+                graph.addItemToFrame(frame, ItemBase::Ptr(new Item<int>(42)));
+            //one event per frame, per edge (in both directions) and per item
+            const double events = graph.num_vertices() + graph.num_edges() + n;
+
+            CountingDispatcher dispatcher;
+            suite.runThroughput("subscribe_current_state", n, std::max<size_t>(10, 10000 / n), events, 0, [](){},
+                                [&](size_t)
+                                {
+                                    dispatcher.subscribe(&graph, true);
+                                    dispatcher.unsubscribe();
+                                });
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t maxSubscribers = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const std::string jsonFile = argc > 2 ? argv[2] : "benchmark_event_throughput.json";
+
+    Suite suite("event_throughput", 3);
+    suite.setAllocationCounter([]() { return allocationCount.load(std::memory_order_relaxed); });
+
+    benchmarkFanout<CountingDispatcher>(suite, "dispatcher", maxSubscribers);
+    benchmarkFanout<CountingItemDispatcher>(suite, "item_dispatcher", maxSubscribers);
+    benchmarkQueue(suite, maxSubscribers);
+    benchmarkPathSubscribers(suite, maxSubscribers);
+    benchmarkCurrentState(suite, maxSubscribers);
+    return suite.writeJson(jsonFile) ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Measures the core graph and transform operations of EnvireGraph on
+ * synthetic graphs (chain, star, balanced tree and random tree with cross
+ * edges) of 10^2 up to 10^5 frames.
+ *
+ * usage: benchmark_graph_operations [max_frames] [json_file] */
+
+#include "Benchmark.hpp"
+#include "GraphGenerators.hpp"
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+
+using namespace envire::core;
+using namespace envire::benchmark;
+
+namespace
+{
+    /**Number of iterations for operations whose costs grow linearly with the graph size */
+    size_t linearIterations(const size_t numFrames)
+    {
+        return std::max<size_t>(10, 1000000 / numFrames);
+    }
+
+    void benchmarkTopology(Suite& suite, const std::string& name, const GraphTopology& topology)
+    {
+        const size_t n = topology.frames.size();
+        const FrameId& root = topology.frames.front();
+        const FrameId& leaf = topology.frames[topology.deepestFrame];
+        std::vector<GraphTopology::Edge> edges(topology.treeEdges);
+        edges.insert(edges.end(), topology.crossEdges.begin(), topology.crossEdges.end());
+
+        std::unique_ptr<EnvireGraph> graph;
+        std::unique_ptr<TreeView> view;
+        auto emptyGraph = [&]()
+        {
+            view.reset();
+            graph.reset(new EnvireGraph());
+            for(const FrameId& frame : topology.frames)
+                graph->addFrame(frame);
+        };
+        auto fullGraph = [&]()
+        {
+            view.reset();
+            graph.reset(new EnvireGraph());
+            buildGraph(*graph, topology);
+        };
+        auto addEdge = [&](size_t i)
+        {
+            graph->addTransform(topology.frames[edges[i].first], topology.frames[edges[i].second], makeTransform(i));
+        };
+
+        suite.run(name + "/addFrame", n, n,
+                  [&]() { view.reset(); graph.reset(new EnvireGraph()); },
+                  [&](size_t i) { graph->addFrame(topology.frames[i]); });
+
+        suite.run(name + "/add_edge", n, edges.size(), emptyGraph, addEdge);
+
+        //add_edge has to update the subscribed tree views (addEdgeToTreeViews)
+        suite.run(name + "/add_edge_treeview", n, edges.size(),
+                  [&]()
+                  {
+                      emptyGraph();
+                      view.reset(new TreeView());
+                      graph->getTree(root, true, view.get());
+                  },
+                  addEdge);
+
+        fullGraph();
+        suite.run(name + "/getTree", n, std::max<size_t>(1, linearIterations(n) / 10),
+                  [&](size_t) { doNotOptimize(graph->getTree(root).tree.size()); });
+
+        suite.run(name + "/getTransform_bfs", n, linearIterations(n),
+                  [&](size_t) { doNotOptimize(graph->getTransform(root, leaf).transform.translation); });
+
+        const TreeView tree = graph->getTree(root);
+        suite.run(name + "/getTransform_treeview", n, linearIterations(n),
+                  [&](size_t) { doNotOptimize(graph->getTransform(root, leaf, tree).transform.translation); });
+
+        FlatTreeView flatTree;
+        suite.run(name + "/getTree_flat", n, std::max<size_t>(1, linearIterations(n) / 10),
+                  [&](size_t)
+                  {
+                      graph->getTree(root, &flatTree);
+                      doNotOptimize(flatTree.size());
+                  });
+        suite.run(name + "/getTransform_flat_treeview", n, linearIterations(n),
+                  [&](size_t) { doNotOptimize(graph->getTransform(root, leaf, flatTree).transform.translation); });
+
+        const GraphTraits::vertex_descriptor rootDesc = graph->getVertex(root);
+        const GraphTraits::vertex_descriptor leafDesc = graph->getVertex(leaf);
+        suite.run(name + "/getPath", n, linearIterations(n),
+                  [&](size_t) { doNotOptimize(graph->getPath(root, leaf, false)->getFrames().size()); });
+        suite.run(name + "/getTransform_vertex_bfs", n, linearIterations(n),
+                  [&](size_t) { doNotOptimize(graph->getTransform(rootDesc, leafDesc).transform.translation); });
+
+        //frames are removed in reverse order, every frame is a leaf of the spanning tree when it is removed
+        auto removeFrame = [&](size_t i)
+        {
+            const FrameId& frame = topology.frames[n - 1 - i];
+            graph->disconnectFrame(frame);
+            graph->removeFrame(frame);
+        };
+        suite.run(name + "/removeFrame", n, n - 1, fullGraph, removeFrame);
+        //the random tree has cross-edges. Removing them from an updating
+        //TreeView needs TreeView::removeEdge() to re-attach sub-trees. Skip
+        //the case if that fails instead of aborting the remaining cases.
+        try
+        {
+            suite.run(name + "/removeFrame_treeview", n, n - 1,
+                      [&]()
+                      {
+                          fullGraph();
+                          view.reset(new TreeView());
+                          graph->getTree(root, true, view.get());
+                      },
+                      removeFrame);
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << name << "/removeFrame_treeview skipped: " << e.what() << std::endl;
+        }
+        view.reset();
+        graph.reset();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t maxFrames = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const std::string jsonFile = argc > 2 ? argv[2] : "benchmark_graph_operations.json";
+
+    Suite suite("graph_operations");
+    for(size_t n = 100; n <= maxFrames; n *= 10)
+    {
+        benchmarkTopology(suite, "chain", makeChain(n));
+        benchmarkTopology(suite, "star", makeStar(n));
+        benchmarkTopology(suite, "balanced_tree", makeBalancedTree(n));
+        benchmarkTopology(suite, "random_tree", makeRandomTree(n, n / 10));
+    }
+    return suite.writeJson(jsonFile) ? 0 : 1;
+}
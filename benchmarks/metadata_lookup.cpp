@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Measures the throughput (calls/sec) of concurrent Item::getClassName calls
+ * using an increasing number of threads. The lock-free ItemMetadataMapping
+ * is compared to a std::unordered_map guarded by a std::mutex, which is how
+ * the mapping was implemented before. */
+
+#include <envire_core/items/Item.hpp>
+#include <envire_core/items/ItemMetadata.hpp>
+#include <boost/thread.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+
+using namespace envire::core;
+
+namespace
+{
+    static MetadataInitializer intMetadata(typeid(Item<int>), "int", "envire::core::Item<int>");
+
+    /**Mimics the previous mutex based mapping */
+    struct LockedMapping
+    {
+        std::unordered_map<std::type_index, ItemMetadata> mapping;
+        std::mutex mutex;
+
+        bool getClassName(const std::type_info& type, std::string& class_name)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            auto it = mapping.find(std::type_index(type));
+            if(it == mapping.end())
+                return false;
+            class_name = it->second.className;
+            return true;
+        }
+    };
+
+    /** @return calls/sec of all threads combined */
+    template <class FUNC>
+    double measure(const size_t numThreads, const size_t callsPerThread, FUNC func)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        boost::thread_group threads;
+        for(size_t i = 0; i < numThreads; ++i)
+        {
+            threads.create_thread([callsPerThread, &func]()
+            {
+                std::string class_name;
+                size_t checksum = 0;
+                for(size_t j = 0; j < callsPerThread; ++j)
+                {
+                    func(class_name);
+                    checksum += class_name.size();
+                }
+                //prevent the compiler from optimizing the loop away
+                volatile size_t sink = checksum;
+                (void)sink;
+            });
+        }
+        threads.join_all();
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        return (numThreads * callsPerThread) / duration.count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t callsPerThread = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const size_t maxThreads = argc > 2 ? std::atoi(argv[2]) : boost::thread::hardware_concurrency();
+
+    const Item<int> item(42);
+    LockedMapping locked;
+    locked.mapping[std::type_index(typeid(Item<int>))] = ItemMetadataMapping::getMetadata(typeid(Item<int>));
+
+    std::cout << "calls per thread: " << callsPerThread << std::endl;
+    std::cout << std::setw(10) << "threads"
+              << std::setw(22) << "lock-free [calls/s]"
+              << std::setw(22) << "mutex [calls/s]" << std::endl;
+    for(size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        const double lockFree = measure(threads, callsPerThread,
+                                        [&item](std::string& name) { item.getClassName(name); });
+        const double mutex = measure(threads, callsPerThread,
+                                     [&locked](std::string& name) { locked.getClassName(typeid(Item<int>), name); });
+        std::cout << std::setw(10) << threads
+                  << std::setw(22) << std::fixed << std::setprecision(0) << lockFree
+                  << std::setw(22) << mutex << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Measures the throughput (items/s and MB/s) of saving, loading and copying
+ * items and graphs. The items are the ones of test/vector_plugin.cpp
+ * (Item<Eigen::Vector3d>) and test/string_plugin.cpp (Item<std::string>),
+ * which are compiled into this executable.
+ * The peak resident set size after each case is part of the JSON results.
+ *
+ * usage: benchmark_serialization_io [frames] [items_per_frame] [string_bytes] [json_file] */
+
+#include "Benchmark.hpp"
+#include "GraphGenerators.hpp"
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/items/Item.hpp>
+#include <envire_core/serialization/Serialization.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <Eigen/Core>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+using namespace envire::core;
+using namespace envire::benchmark;
+
+namespace
+{
+    typedef Item<Eigen::Vector3d> VectorItem;
+    typedef Item<std::string> StringItem;
+
+    /**Builds @p topology and adds @p itemsPerFrame items to each frame.
+     * Vector and string items alternate. */
+    void fillGraph(EnvireGraph& graph, const GraphTopology& topology,
+                   const size_t itemsPerFrame, const size_t stringBytes)
+    {
+        buildGraph(graph, topology);
+        const std::string payload(stringBytes, 'x');
+        size_t n = 0;
+        for(const FrameId& frame : topology.frames)
+        {
+            for(size_t i = 0; i < itemsPerFrame; ++i, ++n)
+            {
+                if(n % 2 == 0)
+                    graph.addItemToFrame(frame, VectorItem::Ptr(new VectorItem(Eigen::Vector3d(n, 2.0 * n, 3.0 * n))));
+                else
+                    graph.addItemToFrame(frame, StringItem::Ptr(new StringItem(payload)));
+            }
+        }
+    }
+
+    size_t fileSize(const std::string& file)
+    {
+        std::ifstream in(file, std::ios::binary | std::ios::ate);
+        return in.is_open() ? static_cast<size_t>(in.tellg()) : 0;
+    }
+
+    /**Measures Serialization::saveToBinary and loadFromBinary of a single item */
+    void benchmarkItem(Suite& suite, const std::string& name, const ItemBase::Ptr& item,
+                       const size_t iterations)
+    {
+        std::vector<uint8_t> binary;
+        Serialization::saveToBinary(binary, item);
+        const double bytes = binary.size();
+
+        //saveToBinary appends, clearing keeps the capacity of the buffer
+        std::vector<uint8_t> out;
+        suite.runThroughput(name + "/saveToBinary", binary.size(), iterations, 1, bytes, [](){},
+                            [&](size_t)
+                            {
+                                out.clear();
+                                Serialization::saveToBinary(out, item);
+                                doNotOptimize(out.data());
+                            });
+        ItemBase::Ptr loaded;
+        suite.runThroughput(name + "/loadFromBinary", binary.size(), iterations, 1, bytes, [](){},
+                            [&](size_t) { Serialization::loadFromBinary(binary, loaded); doNotOptimize(loaded.get()); });
+    }
+
+    /**Measures saving and loading of @p graph using boost archives in memory */
+    template <class OARCHIVE, class IARCHIVE>
+    void benchmarkArchive(Suite& suite, const std::string& name, const EnvireGraph& graph,
+                          const double items)
+    {
+        std::string data;
+        {
+            std::stringstream stream;
+            OARCHIVE oa(stream);
+            oa << graph;
+            data = stream.str();
+        }
+        const size_t frames = graph.num_vertices();
+        suite.runThroughput(name + "/save", frames, 1, items, data.size(), [](){},
+                            [&](size_t)
+                            {
+                                std::stringstream stream;
+                                OARCHIVE oa(stream);
+                                oa << graph;
+                                doNotOptimize(stream.tellp());
+                            });
+        std::unique_ptr<EnvireGraph> loaded;
+        suite.runThroughput(name + "/load", frames, 1, items, data.size(),
+                            [&]() { loaded.reset(new EnvireGraph()); },
+                            [&](size_t)
+                            {
+                                std::stringstream stream(data);
+                                IARCHIVE ia(stream);
+                                ia >> *loaded;
+                            });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t numFrames = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const size_t itemsPerFrame = argc > 2 ? std::atoi(argv[2]) : 10;
+    const size_t stringBytes = argc > 3 ? std::atoi(argv[3]) : 1024;
+    const std::string jsonFile = argc > 4 ? argv[4] : "benchmark_serialization_io.json";
+    const std::string graphFile = "benchmark_serialization_io.graph";
+    const std::string snapshotFile = "benchmark_serialization_io.snapshot";
+
+    std::cout << "frames: " << numFrames << ", items per frame: " << itemsPerFrame
+              << ", string payload: " << stringBytes << " bytes" << std::endl;
+    Suite suite("serialization_io", 3);
+
+    benchmarkItem(suite, "item_vector3d", VectorItem::Ptr(new VectorItem(Eigen::Vector3d(1, 2, 3))), 100000);
+    benchmarkItem(suite, "item_string", StringItem::Ptr(new StringItem(std::string(stringBytes, 'x'))), 100000);
+
+    EnvireGraph graph;
+    fillGraph(graph, makeBalancedTree(numFrames), itemsPerFrame, stringBytes);
+    const double items = numFrames * itemsPerFrame;
+
+    benchmarkArchive<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(suite, "graph_binary_archive", graph, items);
+    benchmarkArchive<boost::archive::text_oarchive, boost::archive::text_iarchive>(suite, "graph_text_archive", graph, items);
+
+    graph.saveToFile(graphFile);
+    const size_t graphFileSize = fileSize(graphFile);
+    suite.runThroughput("graph/saveToFile", numFrames, 1, items, graphFileSize, [](){},
+                        [&](size_t) { graph.saveToFile(graphFile); });
+    std::unique_ptr<EnvireGraph> loaded;
+    suite.runThroughput("graph/loadFromFile", numFrames, 1, items, graphFileSize,
+                        [&]() { loaded.reset(new EnvireGraph()); },
+                        [&](size_t) { loaded->loadFromFile(graphFile); });
+
+    graph.saveSnapshot(snapshotFile);
+    const size_t snapshotFileSize = fileSize(snapshotFile);
+    suite.runThroughput("graph/saveSnapshot", numFrames, 1, items, snapshotFileSize, [](){},
+                        [&](size_t) { graph.saveSnapshot(snapshotFile); });
+    suite.runThroughput("graph/loadSnapshot", numFrames, 1, items, snapshotFileSize,
+                        [&]() { loaded.reset(new EnvireGraph()); },
+                        [&](size_t) { loaded->loadSnapshot(snapshotFile, 1); });
+    loaded.reset();
+
+    //the copy shares the items, only the graph structure and the item lists are copied
+    suite.runThroughput("graph/copy", numFrames, 1, items, 0, [](){},
+                        [&](size_t) { EnvireGraph copy(graph); doNotOptimize(copy.num_vertices()); });
+
+    std::remove(graphFile.c_str());
+    std::remove(snapshotFile.c_str());
+    return suite.writeJson(jsonFile) ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/**Measures the Item construction throughput (items/sec) of the available
+ * uuid generators using an increasing number of threads. */
+
+#include <envire_core/items/Item.hpp>
+#include <envire_core/items/UUIDGenerator.hpp>
+#include <boost/thread.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace envire::core;
+
+namespace
+{
+    /** @return items/sec of all threads combined */
+    double measure(const size_t numThreads, const size_t itemsPerThread)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        boost::thread_group threads;
+        for(size_t i = 0; i < numThreads; ++i)
+        {
+            threads.create_thread([itemsPerThread]()
+            {
+                size_t checksum = 0;
+                for(size_t j = 0; j < itemsPerThread; ++j)
+                {
+                    Item<int> item(42);
+                    checksum += item.getID().data[15];
+                }
+                //prevent the compiler from optimizing the loop away
+                volatile size_t sink = checksum;
+                (void)sink;
+            });
+        }
+        threads.join_all();
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        return (numThreads * itemsPerThread) / duration.count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t itemsPerThread = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const size_t maxThreads = argc > 2 ? std::atoi(argv[2]) : boost::thread::hardware_concurrency();
+
+    std::cout << "items per thread: " << itemsPerThread << std::endl;
+    std::cout << std::setw(10) << "threads"
+              << std::setw(20) << "fast [items/s]"
+              << std::setw(20) << "random [items/s]" << std::endl;
+    for(size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        UUIDGenerator::setGenerator(&UUIDGenerator::generateFast);
+        const double fast = measure(threads, itemsPerThread);
+        UUIDGenerator::setGenerator(&UUIDGenerator::generateRandom);
+        const double random = measure(threads, itemsPerThread);
+        std::cout << std::setw(10) << threads
+                  << std::setw(20) << std::fixed << std::setprecision(0) << fast
+                  << std::setw(20) << random << std::endl;
+    }
+    return 0;
+}
@@ -54,6 +54,10 @@ std::ostream& operator<<(std::ostream& ostream, const GraphEvent& graph_event)
             break;
         case GraphEvent::ITEM_REMOVED_FROM_FRAME:
             ostream << "ITEM_REMOVED_FROM_FRAME";
+            break;
+        case GraphEvent::ITEM_MODIFIED:
+            ostream << "ITEM_MODIFIED";
+            break;
     }
     return ostream;
 }
@@ -44,7 +44,8 @@ namespace envire { namespace core
             ITEM_ADDED_TO_FRAME,
             ITEM_REMOVED_FROM_FRAME,
             FRAME_ADDED,
-            FRAME_REMOVED
+            FRAME_REMOVED,
+            ITEM_MODIFIED
         };
 
         GraphEvent() = delete;
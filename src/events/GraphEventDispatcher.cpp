@@ -29,6 +29,7 @@
 #include <envire_core/events/EdgeEvents.hpp>
 #include <envire_core/events/ItemAddedEvent.hpp>
 #include <envire_core/events/ItemRemovedEvent.hpp>
+#include <envire_core/events/ItemModifiedEvent.hpp>
 #include <envire_core/events/FrameEvents.hpp>
 
 #include <cassert>
@@ -66,6 +67,9 @@ void GraphEventDispatcher::notifyGraphEvent(const GraphEvent& event)
     case GraphEvent::ITEM_REMOVED_FROM_FRAME:
         itemRemoved(dynamic_cast<const ItemRemovedEvent&>(event));
         break;
+    case GraphEvent::ITEM_MODIFIED:
+        itemModified(dynamic_cast<const ItemModifiedEvent&>(event));
+        break;
     default:
       break;
     //no default case because we only handle basic event types here. Item events are handled
@@ -38,6 +38,7 @@ namespace envire { namespace core
     class FrameAddedEvent;
     class FrameRemovedEvent;
     class ItemAddedEvent;
+    class ItemModifiedEvent;
     class GraphEventPublisher;
 
     /**
@@ -67,5 +68,6 @@ namespace envire { namespace core
         virtual void frameRemoved(const FrameRemovedEvent& e) {}
         virtual void itemAdded(const ItemAddedEvent& e) {}
         virtual void itemRemoved(const ItemRemovedEvent& e) {}
+        virtual void itemModified(const ItemModifiedEvent& e) {}
     };
 }}
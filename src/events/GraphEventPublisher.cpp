@@ -33,6 +33,8 @@
 #include <algorithm>
 #include <envire_core/events/GraphEventPublisher.hpp>
 #include <envire_core/events/GraphEventSubscriber.hpp>
+#include <envire_core/util/GraphStats.hpp>
+#include <envire_core/util/Tracing.hpp>
 #include <cassert>
 
 using namespace envire::core;
@@ -48,7 +50,11 @@ void GraphEventPublisher::subscribe(GraphEventSubscriber* pSubscriber, bool publ
 {
     assert(nullptr != pSubscriber);
     if(publish_current_state)
+    {
+        ENVIRE_STATS_TIMER(PUBLISH_CURRENT_STATE);
+        ENVIRE_STATS_COUNT(CURRENT_STATE_PUBLISHED, 1);
         publishCurrentState(pSubscriber);
+    }
 
     if(insideNotify)
       toBeSubscribed.push_back(pSubscriber);
@@ -73,8 +79,19 @@ void GraphEventPublisher::unsubscribe(GraphEventSubscriber* pSubscriber, bool un
     }
 }
 
+bool GraphEventPublisher::hasSubscribers() const
+{
+    return !subscribers.empty() || !toBeSubscribed.empty();
+}
+
 void GraphEventPublisher::notify(const GraphEvent& e)
 {
+    ENVIRE_STATS_TIMER(NOTIFY);
+    ENVIRE_STATS_COUNT(NOTIFY_CALLS, 1);
+    ENVIRE_STATS_COUNT(NOTIFY_SUBSCRIBERS, subscribers.size());
+    ENVIRE_TRACE_SCOPE("notify");
+    ENVIRE_TRACE_ARG("type", static_cast<int64_t>(e.getType()));
+    ENVIRE_TRACE_ARG("subscribers", subscribers.size());
     insideNotify = true;
     
     for(GraphEventSubscriber* pSubscriber : subscribers)
@@ -102,6 +119,7 @@ void GraphEventPublisher::notify(const GraphEvent& e)
 
 void GraphEventPublisher::notifySubscriber(GraphEventSubscriber* pSubscriber, const GraphEvent& e)
 {
+    ENVIRE_STATS_COUNT(CURRENT_STATE_EVENTS, 1);
     pSubscriber->notifyGraphEvent(e);
 }
 
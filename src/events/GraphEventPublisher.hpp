@@ -70,6 +70,10 @@ namespace envire { namespace core
         /**Notify the given subscriber about a certain graph event */
         void notifySubscriber(GraphEventSubscriber* pSubscriber, const GraphEvent& e);
 
+        /** @return true if at least one subscriber is subscribed.
+         *  Can be used to avoid creating events that nobody receives. */
+        bool hasSubscribers() const;
+
         /**
          * @brief Publishes the current state of the graph.
          */
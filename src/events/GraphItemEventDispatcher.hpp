@@ -29,7 +29,9 @@
 #include <envire_core/events/GraphEventPublisher.hpp>
 #include <envire_core/events/ItemAddedEvent.hpp>
 #include <envire_core/events/ItemRemovedEvent.hpp>
+#include <envire_core/events/ItemModifiedEvent.hpp>
 #include <typeindex>
+#include <cassert>
 
 
 namespace envire { namespace core
@@ -57,25 +59,40 @@ namespace envire { namespace core
 
         virtual ~GraphItemEventDispatcher() {}
         
+        /**The event type and the item type_index are checked before casting,
+         * thus static casts are used. In debug builds the item cast is
+         * verified using rtti. */
         void notifyGraphEvent(const GraphEvent& event)
         {
             switch(event.getType())
             {
                 case GraphEvent::ITEM_ADDED_TO_FRAME:
                 {
-                    const ItemAddedEvent& itemEvent = dynamic_cast<const ItemAddedEvent&>(event);
+                    const ItemAddedEvent& itemEvent = static_cast<const ItemAddedEvent&>(event);
                     if(itemEvent.item->getTypeIndex() == itemType)
                     {
-                        itemAdded(TypedItemAddedEvent<T>(itemEvent.frame, boost::dynamic_pointer_cast<T>(itemEvent.item)));
+                        assert(dynamic_cast<T*>(itemEvent.item.get()) != nullptr);
+                        itemAdded(TypedItemAddedEvent<T>(itemEvent.frame, boost::static_pointer_cast<T>(itemEvent.item)));
                     }
                 }
                     break;
                 case GraphEvent::ITEM_REMOVED_FROM_FRAME:  
                 {
-                    const ItemRemovedEvent itemEvent =  dynamic_cast<const ItemRemovedEvent&>(event);
+                    const ItemRemovedEvent& itemEvent = static_cast<const ItemRemovedEvent&>(event);
                     if(itemEvent.item->getTypeIndex() == itemType)
                     {
-                        itemRemoved(TypedItemRemovedEvent<T>(itemEvent.frame, boost::dynamic_pointer_cast<T>(itemEvent.item)));
+                        assert(dynamic_cast<T*>(itemEvent.item.get()) != nullptr);
+                        itemRemoved(TypedItemRemovedEvent<T>(itemEvent.frame, boost::static_pointer_cast<T>(itemEvent.item)));
+                    }
+                }
+                    break;
+                case GraphEvent::ITEM_MODIFIED:
+                {
+                    const ItemModifiedEvent& itemEvent = static_cast<const ItemModifiedEvent&>(event);
+                    if(itemEvent.item->getTypeIndex() == itemType)
+                    {
+                        assert(dynamic_cast<T*>(itemEvent.item.get()) != nullptr);
+                        itemModified(TypedItemModifiedEvent<T>(itemEvent.frame, boost::static_pointer_cast<T>(itemEvent.item)));
                     }
                 }
                     break;
@@ -88,6 +105,7 @@ namespace envire { namespace core
     protected:
         virtual void itemAdded(const TypedItemAddedEvent<T>& event) {}
         virtual void itemRemoved(const TypedItemRemovedEvent<T>& event) {}
+        virtual void itemModified(const TypedItemModifiedEvent<T>& event) {}
         
     private:
         std::type_index itemType;
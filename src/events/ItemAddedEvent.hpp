@@ -50,7 +50,7 @@ namespace envire { namespace core
     template <class T>
     struct TypedItemAddedEvent 
     {
-      TypedItemAddedEvent(const FrameId& frame, const ItemBase::PtrType<T> item) : frame(frame), item(item) {}
+      TypedItemAddedEvent(const FrameId& frame, const ItemBase::PtrType<T>& item) : frame(frame), item(item) {}
 
         GraphEvent* clone() const
         {
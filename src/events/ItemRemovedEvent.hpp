@@ -52,7 +52,7 @@ namespace envire { namespace core
     template <class T>
     struct TypedItemRemovedEvent 
     {
-      TypedItemRemovedEvent(const FrameId& frame, const ItemBase::PtrType<T> item) : frame(frame), item(item) {}
+      TypedItemRemovedEvent(const FrameId& frame, const ItemBase::PtrType<T>& item) : frame(frame), item(item) {}
 
         GraphEvent* clone() const
         {
@@ -26,7 +26,11 @@
 
 
 #include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/serialization/GraphSnapshot.hpp>
+#include <envire_core/serialization/GraphJournal.hpp>
+#include <envire_core/serialization/ItemLoadFilter.hpp>
 #include <fstream>
+#include <deque>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 
@@ -51,6 +55,14 @@ EnvireGraph::EnvireGraph(const EnvireGraph &other) : TransformGraph<Frame>()
     boost::copy_graph(other, graph());
     //copy the labels
     regenerateLabelMap();  
+    //the copy owns the shared items as well
+    observeItemContents(true);
+}
+
+EnvireGraph::~EnvireGraph()
+{
+    //items may outlive the graph
+    observeItemContents(false);
 }
 
 
@@ -78,7 +90,18 @@ EnvireGraph::EnvireGraph(const EnvireGraph &other, std::unordered_set<std::type_
         for(; vertex_it != vertex_end; ++vertex_it)
         {   
             // vertex_iterator->vertex_descriptor
-            Frame::ItemMap& items = graph()[*vertex_it].items;
+            Frame::ItemMap& items = graph()[*vertex_it].getItemMap();
+
+            // item stores are filtered like the regular items
+            Frame::ItemStoreMap& stores = graph()[*vertex_it].stores;
+            for(Frame::ItemStoreMap::const_iterator store_it = stores.begin(); store_it != stores.end();)
+            {
+                const bool contains = filter_list->find(store_it->first) != filter_list->end();
+                if(contains != inclusive)
+                    store_it = stores.erase(store_it);
+                else
+                    ++store_it;
+            }
 
             // parse through all items in vertex (frame)
             // We erase the elements of the map inside of loop
@@ -107,6 +130,8 @@ EnvireGraph::EnvireGraph(const EnvireGraph &other, std::unordered_set<std::type_
             }
         }
     }
+    //the copy owns the remaining shared items as well
+    observeItemContents(true);
 }   
 
   
@@ -119,15 +144,16 @@ void EnvireGraph::addItemToFrame(const FrameId& frame, ItemBase::Ptr item)
 {
     checkFrameValid(frame);
     const std::type_index i(item->getTypeIndex());
-    (*this)[frame].items[i].push_back(item);
+    (*this)[frame].getItemMap()[i].push_back(item);
     item->setFrame(frame);
+    item->addContentsObserver(this);
     notify(ItemAddedEvent(frame, item));
 }
 
 void EnvireGraph::clearFrame(const FrameId& frame)
 {
     checkFrameValid(frame);
-    auto& items = (*this)[frame].items;
+    auto& items = (*this)[frame].getItemMap();
     
     for(Frame::ItemMap::iterator it = items.begin(); it != items.end();)
     {
@@ -136,18 +162,30 @@ void EnvireGraph::clearFrame(const FrameId& frame)
         {
             ItemBase::Ptr removedItem = *it;
             it = list.erase(it);
+            removedItem->removeContentsObserver(this);
             notify(ItemRemovedEvent(frame, removedItem));
         }
         it = items.erase(it);
     }
+    
+    auto& stores = (*this)[frame].stores;
+    for(Frame::ItemStoreMap::iterator it = stores.begin(); it != stores.end();)
+    {
+        ItemStoreBase::Ptr store = it->second;
+        it = stores.erase(it);
+        if(hasSubscribers())
+        {
+            for(std::size_t i = 0; i < store->size(); ++i)
+            {
+                notify(ItemRemovedEvent(frame, store->materialize(i, frame)));
+            }
+        }
+    }
 }
 
 bool EnvireGraph::containsItems(const vertex_descriptor vertex, const std::type_index& type) const
 {
-  const Frame& frame = graph()[vertex];
-
-  auto mapEntry = frame.items.find(type);
-  return mapEntry != frame.items.end();     
+  return graph()[vertex].getItemCount(type) > 0;
 }
 
 bool EnvireGraph::containsItems(const FrameId& frame, const std::type_index& type) const
@@ -190,7 +228,7 @@ std::vector<std::type_index> EnvireGraph::getItemTypes(const vertex_descriptor v
 const Frame::ItemList& EnvireGraph::getItems(const vertex_descriptor frame,
                                              const std::type_index& type) const
 {
-    const Frame::ItemMap& items = graph()[frame].items;
+    const Frame::ItemMap& items = graph()[frame].getItemMap();
     
     if(items.find(type) == items.end())
     {
@@ -231,10 +269,55 @@ void EnvireGraph::removeItemFromFrame(const ItemBase::Ptr item)
     items.erase(itemIt);
     
     item->setFrame("");
+    item->removeContentsObserver(this);
     notify(ItemRemovedEvent(frameId, item));
 
 }
 
+void EnvireGraph::itemContentsChanged(ItemBase& item)
+{
+    if(hasSubscribers())
+    {
+        //the event needs the owning pointer of the item, which is stored in
+        //its frame. Items that this graph does not own are ignored.
+        if(!containsFrame(item.getFrame()))
+            return;
+        const Frame& frame = graph()[getVertex(item.getFrame())];
+        const Frame::ItemMap::const_iterator list = frame.items.find(item.getTypeIndex());
+        if(list == frame.items.end())
+            return;
+        for(const ItemBase::Ptr& ptr : list->second)
+        {
+            if(ptr.get() == &item)
+            {
+                notify(ItemModifiedEvent(item.getFrame(), ptr));
+                return;
+            }
+        }
+    }
+}
+
+void EnvireGraph::observeItemContents(bool observe)
+{
+    vertex_iterator it, end;
+    std::tie(it, end) = getVertices();
+    for(; it != end; ++it)
+    {
+        //pending items are not loaded here, they are attached to the
+        //observer when they are deserialized
+        for(const auto& itemPair : graph()[*it].items)
+        {
+            for(const ItemBase::Ptr& item : itemPair.second)
+            {
+                if(observe)
+                    item->addContentsObserver(this);
+                else
+                    item->removeContentsObserver(this);
+            }
+        }
+    }
+}
+
 void EnvireGraph::publishCurrentState(GraphEventSubscriber* pSubscriber)
 {
     // publish vertices and edges
@@ -245,13 +328,22 @@ void EnvireGraph::publishCurrentState(GraphEventSubscriber* pSubscriber)
     for (boost::tie( vertex_it, vertex_end ) = boost::vertices( graph() ); vertex_it != vertex_end; ++vertex_it)
     {
         const Frame& frame = graph()[*vertex_it];
-        for(Frame::ItemMap::const_iterator item_group = frame.items.begin(); item_group != frame.items.end(); item_group++)
+        for(Frame::ItemMap::const_iterator item_group = frame.getItemMap().begin(); item_group != frame.getItemMap().end(); item_group++)
         {
+            ENVIRE_STATS_COUNT(CURRENT_STATE_ITEMS, item_group->second.size());
             for(Frame::ItemList::const_iterator item = item_group->second.begin(); item != item_group->second.end(); item++)
             {
                 notifySubscriber(pSubscriber, ItemAddedEvent(frame.getId(), *item));
             }
         }
+        for(const auto& storePair : frame.stores)
+        {
+            ENVIRE_STATS_COUNT(CURRENT_STATE_ITEMS, storePair.second->size());
+            for(std::size_t i = 0; i < storePair.second->size(); ++i)
+            {
+                notifySubscriber(pSubscriber, ItemAddedEvent(frame.getId(), storePair.second->materialize(i, frame.getId())));
+            }
+        }
     }
 }
 
@@ -262,13 +354,20 @@ void EnvireGraph::unpublishCurrentState(GraphEventSubscriber* pSubscriber)
     for (boost::tie( vertex_it, vertex_end ) = boost::vertices( graph() ); vertex_it != vertex_end; ++vertex_it)
     {
         const Frame& frame = graph()[*vertex_it];
-        for(Frame::ItemMap::const_iterator item_group = frame.items.begin(); item_group != frame.items.end(); item_group++)
+        for(Frame::ItemMap::const_iterator item_group = frame.getItemMap().begin(); item_group != frame.getItemMap().end(); item_group++)
         {
             for(Frame::ItemList::const_iterator item = item_group->second.begin(); item != item_group->second.end(); item++)
             {
                 notifySubscriber(pSubscriber, ItemRemovedEvent(frame.getId(), *item));
             }
         }
+        for(const auto& storePair : frame.stores)
+        {
+            for(std::size_t i = 0; i < storePair.second->size(); ++i)
+            {
+                notifySubscriber(pSubscriber, ItemRemovedEvent(frame.getId(), storePair.second->materialize(i, frame.getId())));
+            }
+        }
     }
 
     // unpublish vertices and edges
@@ -277,6 +376,9 @@ void EnvireGraph::unpublishCurrentState(GraphEventSubscriber* pSubscriber)
 
 void EnvireGraph::saveToFile(const std::string& file) const
 {
+    ENVIRE_TRACE_SCOPE("saveToFile");
+    ENVIRE_TRACE_ARG("file", file);
+    ENVIRE_TRACE_ARG("frames", num_vertices());
     std::ofstream myfile;
     //set exception bits to ensure that myfile throws in case of error
     myfile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
@@ -286,14 +388,83 @@ void EnvireGraph::saveToFile(const std::string& file) const
     myfile.close();
 }
 
-void EnvireGraph::loadFromFile(const std::string& file)
+void EnvireGraph::loadFromFile(const std::string& file, const LoadOptions& options)
 {
+    ENVIRE_TRACE_SCOPE("loadFromFile");
+    ENVIRE_TRACE_ARG("file", file);
     std::ifstream myfile;
     myfile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     myfile.open(file); //may throw  
     boost::archive::binary_iarchive ia(myfile);
+    ia.get_helper<ItemLoadFilter>(ItemLoadFilter::helperId()).setOptions(&options);
     ia >> *this;
     myfile.close();
+    if(!options.subtreeRoot.empty())
+        loadSubtreeItems(options.subtreeRoot, options.subtreeDepth);
+    ENVIRE_TRACE_ARG("frames", num_vertices());
+}
+
+void EnvireGraph::loadSubtreeItems(const FrameId& root, std::size_t depth)
+{
+    //breadth first search, edges always exist in both directions
+    std::unordered_map<vertex_descriptor, std::size_t> levels;
+    std::deque<vertex_descriptor> queue;
+    const vertex_descriptor rootVertex = getVertex(root); //may throw
+    levels[rootVertex] = 0;
+    queue.push_back(rootVertex);
+    while(!queue.empty())
+    {
+        const vertex_descriptor vertex = queue.front();
+        queue.pop_front();
+        const std::size_t level = levels[vertex];
+        if(level >= depth)
+            continue;
+        out_edge_iterator it, end;
+        std::tie(it, end) = boost::out_edges(vertex, *this);
+        for(; it != end; ++it)
+        {
+            const vertex_descriptor target = boost::target(*it, *this);
+            if(levels.emplace(target, level + 1).second)
+                queue.push_back(target);
+        }
+    }
+    
+    vertex_iterator it, end;
+    std::tie(it, end) = getVertices();
+    for(; it != end; ++it)
+    {
+        Frame& frame = graph()[*it];
+        if(levels.count(*it) > 0)
+        {
+            frame.loadPendingItems();
+        }
+        else
+        {
+            frame.setPendingItems(boost::shared_ptr<PendingItems>());
+            frame.items.clear();
+        }
+    }
+    observeItemContents(true);
+}
+
+void EnvireGraph::saveSnapshot(const std::string& file, unsigned threads) const
+{
+    GraphSnapshot::save(*this, file, threads);
+}
+
+void EnvireGraph::loadSnapshot(const std::string& file)
+{
+    GraphSnapshot::load(*this, file);
+}
+
+void EnvireGraph::loadSnapshot(const std::string& file, unsigned threads)
+{
+    GraphSnapshot::load(*this, file, threads);
+}
+
+size_t EnvireGraph::replay(const std::string& journal)
+{
+    return GraphJournal::replay(*this, journal);
 }
 
 void EnvireGraph::createStructuralCopy(EnvireGraph& destination) const
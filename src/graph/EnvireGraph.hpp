@@ -28,8 +28,11 @@
 
 #include <envire_core/graph/TransformGraph.hpp>
 #include <envire_core/items/Frame.hpp>
+#include <envire_core/items/ItemStore.hpp>
+#include <envire_core/serialization/LoadOptions.hpp>
 #include <envire_core/events/ItemAddedEvent.hpp>
 #include <envire_core/events/ItemRemovedEvent.hpp>
+#include <envire_core/events/ItemModifiedEvent.hpp>
 #include <envire_core/util/Demangle.hpp>
 
 #include <typeindex>
@@ -46,7 +49,7 @@
 namespace envire { namespace core {
 
 //FIXME comment
-class EnvireGraph : public TransformGraph<Frame>
+class EnvireGraph : public TransformGraph<Frame>, public ItemContentsObserver
 {
 public:
     using FRAME_PROP = Frame;
@@ -67,6 +70,10 @@ public:
     using ItemIterator = boost::transform_iterator<ItemBaseCaster<T>, std::vector<ItemBase::Ptr>::const_iterator, T&>;
     template <class T>
     using ItemIteratorPair =  std::pair<ItemIterator<T>, ItemIterator<T>>;
+    /**Range over the regular items and item store entries of type Item<T>.
+     * @see getItemData() */
+    template <class T>
+    using ItemDataRange = std::pair<ItemDataIterator<T>, ItemDataIterator<T>>;
 
     EnvireGraph();
 
@@ -79,8 +86,16 @@ public:
     EnvireGraph(const EnvireGraph &other, 
                 std::unordered_set<std::type_index> *filter_list, bool inclusive);
 
+    /**@note The items are shared with @p other. Both graphs emit
+     *       ItemModifiedEvents for them.*/
     EnvireGraph(const EnvireGraph &other);
     
+    virtual ~EnvireGraph();
+    
+    /**Is called by items of this graph when they report a content change.
+     * Causes ItemModifiedEvent. */
+    virtual void itemContentsChanged(ItemBase& item) override;
+    
 
     /** Adds @p item to the item list in the frame of item
     *  Causes ItemAddedEvent.
@@ -121,12 +136,13 @@ public:
     *  @throw UnknownFrameException if the frame id is invalid
     *  @param frame The frame the item should be added to.
     *  @param item The item that should be added to the frame.
-    *  @note item.frame_name will be set to @p frame.
-    *        This means that it is not possible to use the same item
-    *        in multiple Graphs. */
+    *  @note item.frame_name will be set to @p frame. An item can be shared
+    *        with copies of the graph, but it only knows one frame. Every
+    *        graph that contains it emits ItemModifiedEvents for it. */
     void addItemToFrame(const FrameId& frame, ItemBase::Ptr item);
 
     /**Returns all items of type @p T that are stored in @p frame.
+    * Entries of an item store are not included, see getItemData().
     * @throw UnknownFrameException if the @p frame id is invalid.
     * @param T has to derive from ItemBase.
     * @return a pair iterators [begin, end]. If no items of type @p T
@@ -172,7 +188,8 @@ public:
       *  @param type The described type should derive from ItemBase*/
     bool containsItems(const vertex_descriptor frame, const std::type_index& type) const;
     bool containsItems(const FrameId& frame, const std::type_index& type) const;
-    /** @return the number of items of type @p T in @p frame.
+    /** @return the number of items of type @p T in @p frame, including
+      *          the entries of the item store of that type.
       *  @param T should derive from ItemBase
       *  @throw UnknownFrameException if the @p frame id is invalid.*/
     template <class T>
@@ -190,6 +207,78 @@ public:
     std::vector<std::type_index> getItemTypes(const FrameId& frame) const;
     std::vector<std::type_index> getItemTypes(const vertex_descriptor vd) const;
     
+    /**Enables contiguous storage for items of type Item<T> in @p frame.
+     * Store items are kept in an ItemStore<T> instead of the regular item
+     * list. This avoids one heap allocation per item and is meant for large
+     * numbers of small items. Does nothing if the store already exists.
+     * Items that are added using addItemToFrame() are still stored in the
+     * regular item list.
+     * getItems() only returns the regular items, use getItemData() to access
+     * the regular items and the store entries alike.
+     * @param T the embedded data type, i.e. the T of Item<T>.
+     * @param reserve Number of items to reserve memory for.
+     * @throw UnknownFrameException if the @p frame id is invalid.*/
+    template <class T>
+    void enableItemStore(const FrameId& frame, const std::size_t reserve = 0);
+    
+    /**Adds @p data to the item store of type @p T in @p frame.
+     * Enables the item store if necessary.
+     * Causes ItemAddedEvent containing a materialized copy of the item if
+     * anyone is subscribed to this graph.
+     * @throw UnknownFrameException if the @p frame id is invalid.
+     * @return the uuid of the new item */
+    template <class T>
+    boost::uuids::uuid addItemToStore(const FrameId& frame, const T& data,
+                                      const base::Time& time = base::Time::now());
+    
+    /**Adds a copy of @p item to the item store of type @p T in @p frame.
+     * The copy keeps the time and uuid of @p item.
+     * @see addItemToStore(const FrameId&, const T&, const base::Time&) */
+    template <class T>
+    boost::uuids::uuid addItemToStore(const FrameId& frame, const Item<T>& item);
+    
+    /** @return the item store of type @p T in @p frame.
+     *  @param T the embedded data type, i.e. the T of Item<T>.
+     *  @throw UnknownFrameException if the @p frame id is invalid.
+     *  @throw NoItemsOfTypeInFrameException if the frame has no item store
+     *                                       of type @p T*/
+    template <class T>
+    const ItemStore<T>& getItemStore(const FrameId& frame) const;
+    template <class T>
+    const ItemStore<T>& getItemStore(const vertex_descriptor frame) const;
+    
+    /**Returns the data of all items of type Item<T> in @p frame, i.e. of the
+     * regular items followed by the entries of the item store of type @p T.
+     * The store entries are accessed in place. A copy of an entry is only
+     * created by ItemDataRef::getItem().
+     * @param T the embedded data type, i.e. the T of Item<T>.
+     * @throw UnknownFrameException if the @p frame id is invalid.
+     * @note The iterators are invalidated when items of type Item<T> are
+     *       added to or removed from @p frame.*/
+    template <class T>
+    ItemDataRange<T> getItemData(const FrameId& frame) const;
+    template <class T>
+    ItemDataRange<T> getItemData(const vertex_descriptor frame) const;
+    
+    /** @return true if the item store of type @p T is enabled in @p frame.
+     *  @throw UnknownFrameException if the @p frame id is invalid.*/
+    template <class T>
+    bool hasItemStore(const FrameId& frame) const;
+    
+    /**Removes @p item from the item store of type @p T in @p frame.
+     * Causes ItemRemovedEvent containing a materialized copy of the item if
+     * anyone is subscribed to this graph.
+     * @throw UnknownFrameException if the @p frame id is invalid.
+     * @throw NoItemsOfTypeInFrameException if the frame has no item store
+     *                                       of type @p T
+     * @note Invalidates all iterators of the store.
+     * @return A pair of iterators. The first one points to the element that
+     *         comes after @p item and the second one points to the end of the
+     *         store.*/
+    template <class T>
+    std::pair<typename ItemStore<T>::const_iterator, typename ItemStore<T>::const_iterator>
+    removeItemFromStore(const FrameId& frame, typename ItemStore<T>::const_iterator item);
+    
     
     /**Removes @p frame from the Graph.
     *  A frame can only be removed if there are no edges connected to
@@ -214,10 +303,43 @@ public:
     /**Loads the graph from @p file.
      * Boost serialization is used to load the graph.
      * Only use this with files that have been created by saveToFile().
+     * @param options select the items that should be loaded. Items that are
+     *                not selected are skipped without constructing them.
+     *                Archives written by older versions store the items
+     *                inline, their items are loaded and filtered afterwards.
+     *                The topology is always loaded completely.
      * @throw boost::archive::archive_exception if the serialization failed
      * @throw std::ios_base::failure if the file operation failed
+     * @throw UnknownFrameException if the subtree root of @p options is not
+     *                              part of the graph
      * FIXME I have no idea what happens when the graph already contains data*/
-    void loadFromFile(const std::string& file);
+    void loadFromFile(const std::string& file, const LoadOptions& options = LoadOptions());
+    
+    /**Stores the graph in @p file using the GraphSnapshot format.
+     * @param threads number of threads used to serialize the items. The items
+     *                of different frames are serialized concurrently.
+     * @throw std::ios_base::failure if the file operation failed*/
+    void saveSnapshot(const std::string& file, unsigned threads = 1) const;
+    
+    /**Loads the graph from a snapshot that has been created by saveSnapshot().
+     * The file is memory mapped. The topology is loaded immediately, the items
+     * of each frame are deserialized on first access.
+     * @throw GraphNotEmptyException if the graph already contains frames
+     * @throw InvalidSnapshotException if @p file is not a valid snapshot*/
+    void loadSnapshot(const std::string& file);
+    
+    /**Loads the graph from a snapshot and deserializes all items immediately,
+     * the items of different frames are loaded concurrently by @p threads
+     * threads.
+     * @throw GraphNotEmptyException if the graph already contains frames
+     * @throw InvalidSnapshotException if @p file is not a valid snapshot*/
+    void loadSnapshot(const std::string& file, unsigned threads);
+    
+    /**Applies the events recorded in @p journal to this graph.
+     * @see GraphJournal
+     * @return the number of events that have been applied
+     * @throw InvalidJournalException if @p journal is not a valid journal*/
+    size_t replay(const std::string& journal);
     
     /** Copies all frames and edges from this graph to @p target.
      *  Excludes all items. 
@@ -237,9 +359,18 @@ protected:
     /**Throws UnknownFrameException if @p frame is not part of this graph */
     void checkFrameValid(const FrameId& frame) const;
     
+    /** @return the item store of type @p T in @p frame. Creates it if necessary.*/
+    template <class T>
+    ItemStore<T>& getOrCreateItemStore(const FrameId& frame);
+    
     /**Assert that @p T derives from ItemBase */
     template <class T>
     void assertDerivesFromItemBase() const;
+    
+    /**Registers (@p observe = true) or unregisters this graph as contents
+     * observer of all of its items.
+     * Items that are observed by a different graph are not unregistered. */
+    void observeItemContents(bool observe);
 
     /**
      * @brief Publishes the current state of the graph.
@@ -256,6 +387,13 @@ private:
     /**Grants access to boost serialization */
     friend class boost::serialization::access;
     
+    /**Builds the graph directly when loading snapshots */
+    friend class GraphSnapshot;
+    
+    /**Loads the deferred items of the frames that are at most @p depth
+     * levels below @p root and drops the items of all other frames */
+    void loadSubtreeItems(const FrameId& root, std::size_t depth);
+    
     /**boost serialization method*/
     template <typename Archive>
     void serialize(Archive &ar, const unsigned int version);
@@ -307,7 +445,7 @@ EnvireGraph::getItemsInternal(const vertex_descriptor frame, const FrameId& fram
 {
     assertDerivesFromItemBase<T>();
     
-    const Frame::ItemMap& items = graph()[frame].items;
+    const Frame::ItemMap& items = graph()[frame].getItemMap();
     const std::type_index key(typeid(T));
     
     if(items.find(key) == items.end())
@@ -343,7 +481,7 @@ const EnvireGraph::ItemIterator<T> EnvireGraph::getItem(const vertex_descriptor
     {
        throw std::out_of_range("Out of range: " + boost::lexical_cast<std::string>(i)); 
     }
-    const Frame::ItemMap& items = graph()[frame].items;
+    const Frame::ItemMap& items = graph()[frame].getItemMap();
     const std::type_index key(typeid(T));
     if(items.find(key) == items.end())
     {
@@ -368,8 +506,8 @@ EnvireGraph::removeItemFromFrame(const FrameId& frameId, ItemIterator<T> item)
     
     Frame& frame = (*this)[frameId];
     const std::type_index key(typeid(T));
-    auto mapEntry = frame.items.find(key);
-    if(mapEntry == frame.items.end())
+    auto mapEntry = frame.getItemMap().find(key);
+    if(mapEntry == frame.getItemMap().end())
     {
         throw NoItemsOfTypeInFrameException(frameId, demangleTypeName(key));
     }
@@ -383,6 +521,7 @@ EnvireGraph::removeItemFromFrame(const FrameId& frameId, ItemIterator<T> item)
     ItemBase::Ptr deletedItem = *nonConstBaseIterator;//backup item so we can notify the user
     std::vector<ItemBase::Ptr>::const_iterator next = items.erase(nonConstBaseIterator);
     deletedItem->setFrame("");
+    deletedItem->removeContentsObserver(this);
     notify(ItemRemovedEvent(frameId, deletedItem));
     
     ItemIterator<T> nextIt(next, ItemBaseCaster<T>()); 
@@ -428,23 +567,149 @@ template <class T>
 size_t EnvireGraph::getItemCount(const vertex_descriptor vd) const
 {
     assertDerivesFromItemBase<T>();
+    return graph()[vd].getItemCount(std::type_index(typeid(T)));
+}
+
+template <class T>
+void EnvireGraph::enableItemStore(const FrameId& frame, const std::size_t reserve)
+{
+    getOrCreateItemStore<T>(frame).reserve(reserve);
+}
+
+template <class T>
+ItemStore<T>& EnvireGraph::getOrCreateItemStore(const FrameId& frame)
+{
+    checkFrameValid(frame);
+    ItemStoreBase::Ptr& store = (*this)[frame].stores[std::type_index(typeid(Item<T>))];
+    if(!store)
+    {
+        store.reset(new ItemStore<T>());
+    }
+    return static_cast<ItemStore<T>&>(*store);
+}
+
+template <class T>
+boost::uuids::uuid EnvireGraph::addItemToStore(const FrameId& frame, const T& data,
+                                               const base::Time& time)
+{
+    ItemStore<T>& store = getOrCreateItemStore<T>(frame);
+    const boost::uuids::uuid id = store.push_back(data, time).uuid;
+    if(hasSubscribers())
+    {
+        notify(ItemAddedEvent(frame, store.materialize(store.size() - 1, frame)));
+    }
+    return id;
+}
+
+template <class T>
+boost::uuids::uuid EnvireGraph::addItemToStore(const FrameId& frame, const Item<T>& item)
+{
+    ItemStore<T>& store = getOrCreateItemStore<T>(frame);
+    store.push_back(item);
+    if(hasSubscribers())
+    {
+        notify(ItemAddedEvent(frame, store.materialize(store.size() - 1, frame)));
+    }
+    return item.getID();
+}
+
+template <class T>
+const ItemStore<T>& EnvireGraph::getItemStore(const FrameId& frame) const
+{
+    const vertex_descriptor vd = getVertex(frame); //may throw
+    return getItemStore<T>(vd);
+}
+
+template <class T>
+const ItemStore<T>& EnvireGraph::getItemStore(const vertex_descriptor frame) const
+{
+    const Frame::ItemStoreMap& stores = graph()[frame].stores;
+    const std::type_index key(typeid(Item<T>));
+    auto mapEntry = stores.find(key);
+    if(mapEntry == stores.end())
+    {
+        throw NoItemsOfTypeInFrameException(getFrameId(frame), demangleTypeName(key));
+    }
+    return static_cast<const ItemStore<T>&>(*mapEntry->second);
+}
+
+template <class T>
+EnvireGraph::ItemDataRange<T> EnvireGraph::getItemData(const FrameId& frame) const
+{
+    const vertex_descriptor vd = getVertex(frame); //may throw
+    return getItemData<T>(vd);
+}
+
+template <class T>
+EnvireGraph::ItemDataRange<T> EnvireGraph::getItemData(const vertex_descriptor vd) const
+{
     const Frame& frame = graph()[vd];
-    const std::type_index key(typeid(T));
-    auto mapEntry = frame.items.find(key);
-    if(mapEntry == frame.items.end())
+    const std::type_index key(typeid(Item<T>));
+    
+    const ItemBase::Ptr* items = nullptr;
+    const ItemBase::Ptr* itemsEnd = nullptr;
+    const Frame::ItemMap& itemMap = frame.getItemMap();
+    auto list = itemMap.find(key);
+    if(list != itemMap.end())
+    {
+        items = list->second.data();
+        itemsEnd = items + list->second.size();
+    }
+    
+    //the const_cast is fine, the entries are modified in place like the
+    //data of the regular items returned by getItems()
+    typename ItemStore<T>::Entry* entries = nullptr;
+    typename ItemStore<T>::Entry* entriesEnd = nullptr;
+    auto store = frame.stores.find(key);
+    if(store != frame.stores.end())
+    {
+        ItemStore<T>& typedStore = const_cast<ItemStore<T>&>(static_cast<const ItemStore<T>&>(*store->second));
+        entries = typedStore.data();
+        entriesEnd = entries + typedStore.size();
+    }
+    
+    return std::make_pair(ItemDataIterator<T>(items, itemsEnd, entries, &frame.getId()),
+                          ItemDataIterator<T>(itemsEnd, itemsEnd, entriesEnd, &frame.getId()));
+}
+
+template <class T>
+bool EnvireGraph::hasItemStore(const FrameId& frame) const
+{
+    const vertex_descriptor vd = getVertex(frame); //may throw
+    const Frame::ItemStoreMap& stores = graph()[vd].stores;
+    return stores.find(std::type_index(typeid(Item<T>))) != stores.end();
+}
+
+template <class T>
+std::pair<typename ItemStore<T>::const_iterator, typename ItemStore<T>::const_iterator>
+EnvireGraph::removeItemFromStore(const FrameId& frame, typename ItemStore<T>::const_iterator item)
+{
+    //the const_cast is fine because we are inside the EnvireGraph. The
+    //getter returns const because the user should not be able to manipulate
+    //the store directly.
+    ItemStore<T>& store = const_cast<ItemStore<T>&>(getItemStore<T>(frame)); //may throw
+    ItemBase::Ptr removedItem;
+    if(hasSubscribers())
     {
-        return 0;
+        //backup item so we can notify the user
+        removedItem = store.materialize(item - store.cbegin(), frame);
     }
-    else
+    typename ItemStore<T>::const_iterator next = store.erase(item);
+    if(removedItem)
     {
-        return mapEntry->second.size();
+        notify(ItemRemovedEvent(frame, removedItem));
     }
+    return std::make_pair(next, store.cend());
 }
 
 template <typename Archive>
 void EnvireGraph::serialize(Archive &ar, const unsigned int version)
 {
     ar & BOOST_SERIALIZATION_BASE_OBJECT_NVP(Base);
+    if(Archive::is_loading::value)
+    {
+        observeItemContents(true);
+    }
 }
 
 }}
@@ -0,0 +1,459 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <envire_core/graph/FlatTreeView.hpp>
+#include <envire_core/util/GraphStats.hpp>
+#include <cassert>
+#include <iterator>
+#include <stdexcept>
+
+namespace envire { namespace core
+{
+    using vertex_descriptor = GraphTraits::vertex_descriptor;
+    using edge_descriptor = GraphTraits::edge_descriptor;
+    using Index = FlatTreeView::Index;
+
+    constexpr FlatTreeView::Index FlatTreeView::NO_INDEX;
+
+FlatTreeView::FlatTreeView() : root(GraphTraits::null_vertex()),
+                               rootIndex(NO_INDEX),
+                               bfsOrderValid(false)
+{}
+
+FlatTreeView::FlatTreeView(const TreeView& view) : FlatTreeView()
+{
+    assign(view);
+}
+
+FlatTreeView::FlatTreeView(const FlatTreeView& other) : FlatTreeView()
+{
+    *this = other;
+}
+
+FlatTreeView& FlatTreeView::operator=(const FlatTreeView& other)
+{
+    //WARNING If you add members to this class, make sure
+    //        to copy them!
+    crossEdges = other.crossEdges;
+    root = other.root;
+    vertices = other.vertices;
+    parents = other.parents;
+    firstChildren = other.firstChildren;
+    nextSiblings = other.nextSiblings;
+    prevSiblings = other.prevSiblings;
+    depths = other.depths;
+    indices = other.indices;
+    rootIndex = other.rootIndex;
+    bfsOrder = other.bfsOrder;
+    bfsOrderValid = other.bfsOrderValid;
+    return *this;
+}
+
+void FlatTreeView::assign(const TreeView& view)
+{
+    clear();
+    if(view.root == GraphTraits::null_vertex())
+        return;
+
+    indices.reserve(view.tree.size());
+    addRoot(view.root);
+    //vertices are indexed in bfs order
+    for(Index i = 0; i < vertices.size(); ++i)
+    {
+        for(const vertex_descriptor child : view.tree.at(vertices[i]).children)
+            addVertex(child, i);
+    }
+    crossEdges = view.crossEdges;
+}
+
+void FlatTreeView::track(TreeView& view)
+{
+    untrack();
+    assign(view);
+    trackedEdgeAdded = view.edgeAdded.connect(
+        [this](vertex_descriptor origin, vertex_descriptor target)
+        {
+            addEdge(origin, target);
+        });
+    trackedCrossEdgeAdded = view.crossEdgeAdded.connect(
+        [this](const CrossEdge& edge)
+        {
+            addCrossEdge(edge.origin, edge.target, edge.edge);
+        });
+    trackedEdgeRemoved = view.edgeRemoved.connect(
+        [this](vertex_descriptor origin, vertex_descriptor target)
+        {
+            removeEdge(origin, target);
+        });
+    trackedCrossEdgeRemoved = view.crossEdgeRemoved.connect(
+        [this](const CrossEdge& edge)
+        {
+            removeCrossEdge(edge.origin, edge.target);
+        });
+}
+
+void FlatTreeView::untrack()
+{
+    trackedEdgeAdded.disconnect();
+    trackedCrossEdgeAdded.disconnect();
+    trackedEdgeRemoved.disconnect();
+    trackedCrossEdgeRemoved.disconnect();
+}
+
+void FlatTreeView::clear()
+{
+    crossEdges.clear();
+    root = GraphTraits::null_vertex();
+    vertices.clear();
+    parents.clear();
+    firstChildren.clear();
+    nextSiblings.clear();
+    prevSiblings.clear();
+    depths.clear();
+    indices.clear();
+    rootIndex = NO_INDEX;
+    bfsOrder.clear();
+    bfsOrderValid = false;
+}
+
+bool FlatTreeView::hasRoot() const
+{
+    return root != GraphTraits::null_vertex();
+}
+
+bool FlatTreeView::isRoot(const vertex_descriptor vd) const
+{
+    return vd == root;
+}
+
+bool FlatTreeView::edgeExists(const vertex_descriptor a, const vertex_descriptor b) const
+{
+    const Index aIndex = getIndex(a);
+    const Index bIndex = getIndex(b);
+    if(aIndex == NO_INDEX || bIndex == NO_INDEX)
+    {
+        return false;
+    }
+    return parents[aIndex] == bIndex || parents[bIndex] == aIndex;
+}
+
+bool FlatTreeView::vertexExists(const vertex_descriptor vd) const
+{
+    return indices.find(vd) != indices.end();
+}
+
+vertex_descriptor FlatTreeView::getParent(const vertex_descriptor node) const
+{
+    if (node == GraphTraits::null_vertex())
+    {
+      throw std::runtime_error("envire_core:FlatTreeView::getParent: Node is null vertex.");
+    }
+    const Index i = getIndex(node);
+    if(i == NO_INDEX)
+    {
+      throw std::runtime_error("envire_core:FlatTreeView::getParent: Node is not in the tree.");
+    }
+    return parentVertex(i);
+}
+
+bool FlatTreeView::isParent(const vertex_descriptor parent, const vertex_descriptor child) const
+{
+    return parentVertex(indices.at(child)) == parent;
+}
+
+const std::vector<Index>& FlatTreeView::getBfsOrder() const
+{
+    if(!bfsOrderValid)
+    {
+        bfsOrder.clear();
+        bfsOrder.reserve(vertices.size());
+        if(rootIndex != NO_INDEX)
+        {
+            bfsOrder.push_back(rootIndex);
+            for(std::size_t i = 0; i < bfsOrder.size(); ++i)
+            {
+                for(Index child = firstChildren[bfsOrder[i]]; child != NO_INDEX; child = nextSiblings[child])
+                    bfsOrder.push_back(child);
+            }
+        }
+        bfsOrderValid = true;
+    }
+    return bfsOrder;
+}
+
+Index FlatTreeView::checkedIndex(const vertex_descriptor vd) const
+{
+    const Index i = getIndex(vd);
+    if(i == NO_INDEX)
+    {
+        throw std::runtime_error("envire_core:FlatTreeView: node is not in the tree or is null vertex.");
+    }
+    return i;
+}
+
+Index FlatTreeView::addVertex(const vertex_descriptor vd, const Index parent)
+{
+    assert(vertices.size() < NO_INDEX);
+    const Index i = static_cast<Index>(vertices.size());
+    const bool inserted = indices.emplace(vd, i).second;
+    assert(inserted);
+    (void)inserted;
+    vertices.push_back(vd);
+    parents.push_back(parent);
+    firstChildren.push_back(NO_INDEX);
+    prevSiblings.push_back(NO_INDEX);
+    if(parent != NO_INDEX)
+    {
+        //children are appended to the front of the sibling list
+        nextSiblings.push_back(firstChildren[parent]);
+        if(firstChildren[parent] != NO_INDEX)
+            prevSiblings[firstChildren[parent]] = i;
+        firstChildren[parent] = i;
+        depths.push_back(depths[parent] + 1);
+    }
+    else
+    {
+        nextSiblings.push_back(NO_INDEX);
+        depths.push_back(0);
+    }
+    bfsOrderValid = false;
+    return i;
+}
+
+void FlatTreeView::addRoot(vertex_descriptor root)
+{
+    assert(vertices.empty());
+    rootIndex = addVertex(root, NO_INDEX);
+    this->root = root;
+}
+
+void FlatTreeView::addEdge(vertex_descriptor origin, vertex_descriptor target)
+{
+    addVertex(target, checkedIndex(origin));
+    edgeAdded(origin, target);
+}
+
+void FlatTreeView::addCrossEdge(const vertex_descriptor origin,
+                                const vertex_descriptor target,
+                                const edge_descriptor edge)
+{
+    crossEdges.emplace_back(origin, target, edge);
+    crossEdgeAdded(crossEdges.back());
+}
+
+void FlatTreeView::removeLeaf(const Index i)
+{
+    assert(firstChildren[i] == NO_INDEX);
+
+    //unlink i from the sibling list of its parent
+    if(prevSiblings[i] != NO_INDEX)
+        nextSiblings[prevSiblings[i]] = nextSiblings[i];
+    else if(parents[i] != NO_INDEX)
+        firstChildren[parents[i]] = nextSiblings[i];
+    if(nextSiblings[i] != NO_INDEX)
+        prevSiblings[nextSiblings[i]] = prevSiblings[i];
+    indices.erase(vertices[i]);
+
+    //move the last vertex into the gap to keep the indices dense
+    const Index last = static_cast<Index>(vertices.size() - 1);
+    if(i != last)
+    {
+        vertices[i] = vertices[last];
+        parents[i] = parents[last];
+        firstChildren[i] = firstChildren[last];
+        nextSiblings[i] = nextSiblings[last];
+        prevSiblings[i] = prevSiblings[last];
+        depths[i] = depths[last];
+        indices[vertices[i]] = i;
+
+        //redirect the links to the moved vertex
+        if(prevSiblings[i] != NO_INDEX)
+            nextSiblings[prevSiblings[i]] = i;
+        else if(parents[i] != NO_INDEX)
+            firstChildren[parents[i]] = i;
+        if(nextSiblings[i] != NO_INDEX)
+            prevSiblings[nextSiblings[i]] = i;
+        for(Index child = firstChildren[i]; child != NO_INDEX; child = nextSiblings[child])
+            parents[child] = i;
+        if(rootIndex == last)
+            rootIndex = i;
+    }
+    vertices.pop_back();
+    parents.pop_back();
+    firstChildren.pop_back();
+    nextSiblings.pop_back();
+    prevSiblings.pop_back();
+    depths.pop_back();
+    bfsOrderValid = false;
+}
+
+void FlatTreeView::removeEdge(vertex_descriptor origin, vertex_descriptor target)
+{
+    ENVIRE_STATS_TIMER(FLAT_TREE_VIEW_REMOVE_EDGE);
+
+    const Index originIndex = checkedIndex(origin);
+    const Index targetIndex = checkedIndex(target);
+    Index subTreeRoot = NO_INDEX;
+    //figure out which of the vertices is acutally the child in the tree
+    if(parents[targetIndex] == originIndex)
+    {
+        subTreeRoot = targetIndex;
+    }
+    else if(parents[originIndex] == targetIndex)
+    {
+        subTreeRoot = originIndex;
+    }
+    else
+    {
+        throw std::runtime_error("envire_core:FlatTreeView::removeEdge: edge is not part of the tree.");
+    }
+
+    //collect the sub-tree in bfs order. Descriptors are stored instead of
+    //indices because removing a vertex moves another vertex to its index.
+    std::vector<vertex_descriptor> removed(1, vertices[subTreeRoot]);
+    std::vector<Index> queue(1, subTreeRoot);
+    for(std::size_t i = 0; i < queue.size(); ++i)
+    {
+        for(Index child = firstChildren[queue[i]]; child != NO_INDEX; child = nextSiblings[child])
+        {
+            queue.push_back(child);
+            removed.push_back(vertices[child]);
+        }
+    }
+    ENVIRE_STATS_COUNT(FLAT_TREE_VIEW_REMOVED_VERTICES, removed.size());
+
+    std::vector<bool> inSubTree(vertices.size(), false);
+    for(const Index i : queue)
+        inSubTree[i] = true;
+    auto isInSubTree = [this, &inSubTree](const vertex_descriptor vd)
+    {
+        const Index i = getIndex(vd);
+        return i != NO_INDEX && inSubTree[i];
+    };
+    auto isConnected = [&isInSubTree](const CrossEdge& edge)
+    {
+        return isInSubTree(edge.origin) || isInSubTree(edge.target);
+    };
+
+    //all cross-edges that are connected to the sub-tree
+    std::vector<CrossEdge> subTreeCrossEdges;
+    std::copy_if(crossEdges.begin(), crossEdges.end(),
+                 std::back_inserter(subTreeCrossEdges), isConnected);
+    crossEdges.erase(std::remove_if(crossEdges.begin(), crossEdges.end(), isConnected),
+                     crossEdges.end());
+
+    //the first cross-edge that leaves the sub-tree is used to re-attach it
+    const CrossEdge* attachEdge = nullptr;
+    for(const CrossEdge& edge : subTreeCrossEdges)
+    {
+        if(isInSubTree(edge.origin) != isInSubTree(edge.target))
+        {
+            attachEdge = &edge;
+            break;
+        }
+    }
+
+    //re-root the sub-tree at the vertex of attachEdge, @see TreeView::removeEdge
+    std::vector<std::pair<vertex_descriptor, vertex_descriptor>> reattachedEdges;
+    if(attachEdge != nullptr)
+    {
+        const Index newRoot = isInSubTree(attachEdge->origin) ? indices.at(attachEdge->origin) :
+                                                                 indices.at(attachEdge->target);
+        std::vector<bool> visited(vertices.size(), false);
+        std::vector<Index> toVisit(1, newRoot);
+        visited[newRoot] = true;
+        for(std::size_t i = 0; i < toVisit.size(); ++i)
+        {
+            const Index current = toVisit[i];
+            auto visit = [&](const Index next)
+            {
+                if(!visited[next])
+                {
+                    visited[next] = true;
+                    reattachedEdges.emplace_back(vertices[current], vertices[next]);
+                    toVisit.push_back(next);
+                }
+            };
+            //the edge between subTreeRoot and its parent is the one that is removed
+            if(current != subTreeRoot)
+                visit(parents[current]);
+            for(Index child = firstChildren[current]; child != NO_INDEX; child = nextSiblings[child])
+                visit(child);
+        }
+        ENVIRE_STATS_COUNT(FLAT_TREE_VIEW_REATTACHED_VERTICES, removed.size());
+    }
+
+    for(const CrossEdge& edge : subTreeCrossEdges)
+        crossEdgeRemoved(edge);
+
+    //remove vertices in reverse order to ensure that the parent is still in the
+    //tree when the event is emitted.
+    while(!removed.empty())
+    {
+        const vertex_descriptor node = removed.back();
+        removed.pop_back();
+        const Index i = indices.at(node);
+        const vertex_descriptor parent = parentVertex(i);
+        removeLeaf(i);
+        edgeRemoved(parent, node);
+    }
+
+    if(attachEdge != nullptr)
+    {
+        if(vertexExists(attachEdge->origin))
+            addEdge(attachEdge->origin, attachEdge->target);
+        else
+            addEdge(attachEdge->target, attachEdge->origin);
+
+        for(const auto& edge : reattachedEdges)
+            addEdge(edge.first, edge.second);
+
+        for(const CrossEdge& edge : subTreeCrossEdges)
+        {
+            if(&edge != attachEdge)
+                addCrossEdge(edge.origin, edge.target, edge.edge);
+        }
+    }
+}
+
+bool FlatTreeView::removeCrossEdge(vertex_descriptor a, vertex_descriptor b)
+{
+    std::vector<CrossEdge>::iterator edge = std::find_if(crossEdges.begin(), crossEdges.end(),
+        [a, b](const CrossEdge& e)
+        {
+            return (e.origin == a && e.target == b) || (e.origin == b && e.target == a);
+        });
+    if(edge == crossEdges.end())
+    {
+        return false;
+    }
+    const CrossEdge removed = *edge;
+    crossEdges.erase(edge);
+    crossEdgeRemoved(removed);
+    return true;
+}
+
+}}
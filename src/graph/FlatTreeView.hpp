@@ -0,0 +1,235 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <envire_core/graph/TreeView.hpp>
+#include <boost/signals2.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace envire { namespace core
+{
+    /** A cache friendly variant of the TreeView.
+     *
+     *  Every vertex of the tree gets a dense index. Parent, first child and
+     *  next sibling relations as well as the depth are stored in flat arrays
+     *  that are indexed by it. The only hash lookup is the mapping from
+     *  vertex_descriptor to index, which is done once per query. Traversals
+     *  only access the arrays.
+     *
+     *  The view can be built directly by Graph::getTree() or from a TreeView.
+     *  A FlatTreeView that tracks an updating TreeView (see track()) follows
+     *  all its updates and emits the same signals as the TreeView.
+     */
+    class FlatTreeView
+    {
+    public:
+        using Index = uint32_t;
+        static constexpr Index NO_INDEX = std::numeric_limits<Index>::max();
+
+        using CrossEdge = TreeView::CrossEdge;
+
+        FlatTreeView();
+
+        /**Creates a copy of @p view */
+        explicit FlatTreeView(const TreeView& view);
+
+        /**Creates a copy ***without*** the signal subscribers and the tracked TreeView */
+        FlatTreeView(const FlatTreeView& other);
+
+        /**Copies ***without*** the signal subscribers and the tracked TreeView */
+        FlatTreeView& operator=(const FlatTreeView& other);
+
+        /**Replaces the content with a copy of @p view.
+         * The vertices are indexed in bfs order. */
+        void assign(const TreeView& view);
+
+        /**Copies @p view and keeps following its updates until untrack() is
+         * called or the view is destroyed. @p view should be an updating
+         * TreeView, i.e. subscribed to the graph. */
+        void track(TreeView& view);
+
+        /**Stops following the updates of the tracked TreeView */
+        void untrack();
+
+        /**Removes all content from this view */
+        void clear();
+
+        bool hasRoot() const;
+        bool isRoot(const GraphTraits::vertex_descriptor vd) const;
+
+        /** @return the number of vertices in the tree */
+        std::size_t size() const { return vertices.size(); }
+
+        /**Returns true if an edge between a and b exists and is not a cross-edge*/
+        bool edgeExists(const GraphTraits::vertex_descriptor a, const GraphTraits::vertex_descriptor b) const;
+        bool vertexExists(const GraphTraits::vertex_descriptor vd) const;
+
+        /** Returns the parent of @p node. Returns null_vertex if there is no parent
+         * @throw std::runtime_error if @p node is not in the tree*/
+        GraphTraits::vertex_descriptor getParent(const GraphTraits::vertex_descriptor node) const;
+
+        /** @return true if @p parent is the parent of @p child
+         * @throw std::out_of_range if child is not part of the view*/
+        bool isParent(const GraphTraits::vertex_descriptor parent, const GraphTraits::vertex_descriptor child) const;
+
+        /** @return the index of @p vd or NO_INDEX if it is not part of the tree */
+        Index getIndex(const GraphTraits::vertex_descriptor vd) const
+        {
+            const auto it = indices.find(vd);
+            return it == indices.end() ? NO_INDEX : it->second;
+        }
+
+        GraphTraits::vertex_descriptor getVertex(const Index i) const { return vertices[i]; }
+        Index getParentIndex(const Index i) const { return parents[i]; }
+        Index getFirstChild(const Index i) const { return firstChildren[i]; }
+        Index getNextSibling(const Index i) const { return nextSiblings[i]; }
+        /** @return the distance of @p i to the root */
+        Index getDepth(const Index i) const { return depths[i]; }
+        Index getRootIndex() const { return rootIndex; }
+
+        /** @return the indices of all vertices in bfs order starting at the root.
+         *  The order is recomputed lazily after the tree has been modified. */
+        const std::vector<Index>& getBfsOrder() const;
+
+        /**visits all vertices in the tree starting at @p node in dfs order.
+         * I.e. it first visits node, then all its children.
+         * Calls @p f(const vertex_descriptor node, const vertex_descriptor parent) for each node.*/
+        template <class Func>
+        void visitDfs(const GraphTraits::vertex_descriptor node, Func f) const
+        {
+            const Index start = checkedIndex(node);
+            std::vector<Index> stack(1, start);
+            while(!stack.empty())
+            {
+                const Index current = stack.back();
+                stack.pop_back();
+                f(vertices[current], parentVertex(current));
+                //push in reverse order to visit the first child first
+                const std::size_t begin = stack.size();
+                for(Index child = firstChildren[current]; child != NO_INDEX; child = nextSiblings[child])
+                    stack.push_back(child);
+                std::reverse(stack.begin() + begin, stack.end());
+            }
+        }
+
+        /**visits all vertices in the tree starting at @p node in bfs order.
+         * Calls @p f(vertex_descriptor node, vertex_descriptor parent) for each node.*/
+        template <class Func>
+        void visitBfs(const GraphTraits::vertex_descriptor node, Func f) const
+        {
+            const Index start = checkedIndex(node);
+            if(start == rootIndex)
+            {
+                for(const Index current : getBfsOrder())
+                    f(vertices[current], parentVertex(current));
+                return;
+            }
+            std::vector<Index> queue(1, start);
+            for(std::size_t i = 0; i < queue.size(); ++i)
+            {
+                const Index current = queue[i];
+                f(vertices[current], parentVertex(current));
+                for(Index child = firstChildren[current]; child != NO_INDEX; child = nextSiblings[child])
+                    queue.push_back(child);
+            }
+        }
+
+        /**Adds the initial root node */
+        void addRoot(GraphTraits::vertex_descriptor root);
+
+        /**Add an edge to the view. @p origin has to be part of the view.
+         * Emits edgeAdded*/
+        void addEdge(GraphTraits::vertex_descriptor origin, GraphTraits::vertex_descriptor target);
+
+        /**Add a cross edge to the view.
+         * Emits crossEdgeAdded */
+        void addCrossEdge(const GraphTraits::vertex_descriptor origin,
+                          const GraphTraits::vertex_descriptor target,
+                          const GraphTraits::edge_descriptor edge);
+
+        /**Removes an edge and the sub-tree below it from the view.
+         * Emits crossEdgeRemoved for each cross edge connected to the sub-tree
+         * and edgeRemoved for each edge that is removed, starting from the
+         * deepest edge. If a cross edge connects the sub-tree to the rest of the
+         * tree, the sub-tree is re-attached through it, @see TreeView::removeEdge */
+        void removeEdge(GraphTraits::vertex_descriptor origin, GraphTraits::vertex_descriptor target);
+
+        /**Removes the cross-edge between @p a and @p b, regardless of its direction.
+         * Emits crossEdgeRemoved.
+         * @return false if there is no cross-edge between @p a and @p b */
+        bool removeCrossEdge(GraphTraits::vertex_descriptor a, GraphTraits::vertex_descriptor b);
+
+        /**@see TreeView */
+        boost::signals2::signal<void (const CrossEdge&)> crossEdgeAdded;
+        boost::signals2::signal<void (GraphTraits::vertex_descriptor origin,
+                                      GraphTraits::vertex_descriptor target)> edgeAdded;
+        boost::signals2::signal<void (GraphTraits::vertex_descriptor origin,
+                                      GraphTraits::vertex_descriptor target)> edgeRemoved;
+        boost::signals2::signal<void (const CrossEdge&)> crossEdgeRemoved;
+
+        /**@see TreeView::crossEdges */
+        std::vector<CrossEdge> crossEdges;
+
+        /**The root node of this view */
+        GraphTraits::vertex_descriptor root;
+
+    private:
+        Index checkedIndex(const GraphTraits::vertex_descriptor vd) const;
+
+        GraphTraits::vertex_descriptor parentVertex(const Index i) const
+        {
+            return parents[i] == NO_INDEX ? GraphTraits::null_vertex() : vertices[parents[i]];
+        }
+
+        Index addVertex(const GraphTraits::vertex_descriptor vd, const Index parent);
+
+        /**Removes the leaf @p i. The last vertex is moved to index @p i */
+        void removeLeaf(const Index i);
+
+        std::vector<GraphTraits::vertex_descriptor> vertices;
+        std::vector<Index> parents;
+        std::vector<Index> firstChildren;
+        std::vector<Index> nextSiblings;
+        /** Makes unlinking a vertex from the sibling list O(1) */
+        std::vector<Index> prevSiblings;
+        std::vector<Index> depths;
+        std::unordered_map<GraphTraits::vertex_descriptor, Index> indices;
+        Index rootIndex;
+
+        mutable std::vector<Index> bfsOrder;
+        mutable bool bfsOrderValid;
+
+        boost::signals2::scoped_connection trackedEdgeAdded;
+        boost::signals2::scoped_connection trackedCrossEdgeAdded;
+        boost::signals2::scoped_connection trackedEdgeRemoved;
+        boost::signals2::scoped_connection trackedCrossEdgeRemoved;
+    };
+}}
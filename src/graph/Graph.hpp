@@ -38,9 +38,13 @@
 
 #include <envire_core/graph/GraphTypes.hpp>
 #include <envire_core/graph/TreeView.hpp>
+#include <envire_core/graph/FlatTreeView.hpp>
+#include <envire_core/graph/TraversalWorkspace.hpp>
 #include <envire_core/graph/GraphExceptions.hpp>
 #include <envire_core/graph/GraphVisitors.hpp>
 #include <envire_core/graph/Path.hpp>
+#include <envire_core/util/GraphStats.hpp>
+#include <envire_core/util/Tracing.hpp>
 
 
 namespace envire { namespace core
@@ -237,6 +241,14 @@ public:
     TreeView getTree(const FrameId rootId) const;
     void getTree(const FrameId rootId, TreeView* outView) const;
     void getTree(const vertex_descriptor root, TreeView* outView) const;
+
+    /**Builds a FlatTreeView containing all vertices that are accessible starting
+      * from @p root. The previous content of @p outView is discarded.
+      * @note The tree is ***not** updated when the Graph changes. Use
+      *       FlatTreeView::track() with an updating TreeView instead.
+      * @throw UnknownFrameException if the frame does not exist */
+    void getTree(const vertex_descriptor root, FlatTreeView* outView) const;
+    void getTree(const FrameId rootId, FlatTreeView* outView) const;
     
     /**Builds a TreeView containing all vertices that are accessible starting
       * from @p root and writes it to @p outView.
@@ -266,10 +278,13 @@ public:
      * 
      * @throw UnknownFrameException if @p origin or @p target don't exist.
      * @param autoUpdating If true, an auto updating path will be returned.
-     *                     I.e. a path that is subscribed to graph and
+     *                     I.e. a path that is registered with the graph and
      *                     notices when an edge on the path is removed*/
     Path::Ptr getPath(const FrameId& origin, const FrameId& target,
                                   const bool autoUpdating);
+
+    /** @return the registry of all auto updating paths of this graph */
+    const PathRegistry& getPathRegistry() const { return pathRegistry; }
        
     
     /** @return number of frames in this graph*/
@@ -284,17 +299,30 @@ public:
     static vertex_descriptor null_vertex();
     
     /** Visit Graph in bfs order.
-     * This is a wrapper around boost::breadth_first_search that correctly
-     * parameterizes boost::breadth_first_search to work with this graph. */
+     * This is a wrapper around boost::breadth_first_visit that correctly
+     * parameterizes boost::breadth_first_visit to work with this graph.
+     * The color map and the queue are provided by the TraversalWorkspace of
+     * the calling thread. Only the reachable vertices are touched, i.e.
+     * initialize_vertex() of the visitor is ***not*** invoked.
+     * @param visitor bgl named parameters, e.g. boost::visitor(vis) */
     template <class VISITOR>
     void breadthFirstSearch(const vertex_descriptor root, VISITOR visitor) const;
     
-    /** Visit Graph in bfs order.
-     * This is a wrapper around boost::breadth_first_search that correctly
-     * parameterizes boost::breadth_first_search to work with this graph. */
+    /** Visit @p graph in bfs order.
+     * @param graph this graph or an adaptor of it, e.g. a boost::filtered_graph
+     * @see breadthFirstSearch(const vertex_descriptor, VISITOR) */
     template <class GRAPH, class VISITOR>
     void breadthFirstSearch(GRAPH& graph, const vertex_descriptor root, VISITOR visitor) const;
 
+    /** @return the index of @p vd in [0, getVertexIndexBound()).
+     *  Indices are unique but not necessarily dense. They can be used to
+     *  index a TraversalWorkspace::Scope in custom traversals.
+     *  @note Indices may change when frames are removed. */
+    std::size_t getVertexIndex(const vertex_descriptor vd) const;
+
+    /** @return an upper bound of all vertex indices */
+    std::size_t getVertexIndexBound() const;
+
     template <class VISITOR>
     EIGEN_DEPRECATED
     void breathFirstSearch(const vertex_descriptor root, VISITOR visitor) const { breadthFirstSearch(root, visitor); }
@@ -343,13 +371,17 @@ protected:
      */
     virtual void unpublishCurrentState(GraphEventSubscriber* pSubscriber);
     
-    /**Re-generates the content of _map based on the FrameIds.
+    /**Re-generates the content of _map based on the FrameIds and renumbers
+     * the vertex indices.
      * This method is used when de-serializing or copying the graph.*/
     void regenerateLabelMap();
     
     
     /**TreeViews that need to be updated when the graph is modified */
     std::vector<TreeView*> subscribedTreeViews;
+
+    /**Auto updating paths that need to be dirtied when an edge is removed */
+    PathRegistry pathRegistry;
     
 private:
     /**Grants access to boost serialization */
@@ -507,6 +539,12 @@ void Graph<F,E>::removeFrame(const FrameId& frame)
     }
     
     boost::remove_vertex(desc, graph());//If the HACK is removed, remove_vertex needs to be called with frame as first parameter
+    //removing vertices leaves gaps in the vertex indices, compact them
+    //once the gaps dominate to bound the size of the traversal workspace
+    if(graph().max_vertex_index() > 2 * graph().num_vertices() + 64)
+    {
+        graph().renumber_vertex_indices();
+    }
     //HACK this is a workaround for bug https://svn.boost.org/trac/boost/ticket/9493
     //If the bug is fixed also remove the #define private protected in GraphTypes.hpp
     typename map_type::iterator it = _map.find(frame);
@@ -559,9 +597,31 @@ void Graph<F,E>::getTree(const FrameId rootId, const bool keepTreeUpdated, TreeV
 template <class F, class E>
 void Graph<F,E>::getTree(const vertex_descriptor root, TreeView* outView) const
 {
+    ENVIRE_TRACE_SCOPE("getTree");
+    ENVIRE_TRACE_ARG("root", getFrameId(root));
     outView->addRoot(root);
     TreeBuilderVisitor<Graph<F,E>> visitor(*outView, *this);
     breadthFirstSearch(root, boost::visitor(visitor));
+    ENVIRE_TRACE_ARG("vertices", outView->tree.size());
+}
+
+template <class F, class E>
+void Graph<F,E>::getTree(const FrameId rootId, FlatTreeView* outView) const
+{
+    const vertex_descriptor root = getVertex(rootId);
+    getTree(root, outView);
+}
+
+template <class F, class E>
+void Graph<F,E>::getTree(const vertex_descriptor root, FlatTreeView* outView) const
+{
+    ENVIRE_TRACE_SCOPE("getTree");
+    ENVIRE_TRACE_ARG("root", getFrameId(root));
+    outView->clear();
+    outView->addRoot(root);
+    TreeBuilderVisitor<Graph<F,E>, FlatTreeView> visitor(*outView, *this);
+    breadthFirstSearch(root, boost::visitor(visitor));
+    ENVIRE_TRACE_ARG("vertices", outView->size());
 }
 
 template <class F, class E>
@@ -588,6 +648,7 @@ std::vector<FrameId> Graph<F,E>::getFrames(FrameId origin, FrameId target) const
   
     std::vector<FrameId> path;
     envire::core::GraphBFSVisitor <vertex_descriptor>visit(toDesc, this->graph());
+    ENVIRE_STATS_COUNT(PATH_BFS, 1);
     try
     {
         breadthFirstSearch(fromDesc, boost::visitor(visit));
@@ -600,6 +661,8 @@ std::vector<FrameId> Graph<F,E>::getFrames(FrameId origin, FrameId target) const
             path.push_back(getFrameId(*it));
         }
     }
+    //every discovered vertex except the root has a parent
+    ENVIRE_STATS_COUNT(PATH_BFS_VERTICES, visit.parent->size() + 1);
     if(path.size() > 0)
     {
         path.push_back(target);
@@ -626,6 +689,10 @@ void Graph<F,E>::add_edge(const vertex_descriptor origin,
                           const vertex_descriptor target,
                           const E& edgeProperty)
 {   
+    ENVIRE_TRACE_SCOPE("add_edge");
+    ENVIRE_TRACE_ARG("origin", getFrameId(origin));
+    ENVIRE_TRACE_ARG("target", getFrameId(target));
+    ENVIRE_TRACE_ARG("tree_views", subscribedTreeViews.size());
     //check if an edge already exists
     //If a->b exists, b->a also exist. Therefore we need to check only one direction
     EdgePair e = boost::edge(origin, target, *this);
@@ -676,6 +743,10 @@ void Graph<F,E>::remove_edge(const FrameId& origin, const FrameId& target,
                              const vertex_descriptor originDesc, 
                              const vertex_descriptor targetDesc)
 {
+    ENVIRE_TRACE_SCOPE("remove_edge");
+    ENVIRE_TRACE_ARG("origin", origin);
+    ENVIRE_TRACE_ARG("target", target);
+    ENVIRE_TRACE_ARG("tree_views", subscribedTreeViews.size());
     //note: do not use boost::edge_by_label as it will segfault if one of the
     //frames is not part of the tree.
     EdgePair originToTarget = boost::edge(originDesc, targetDesc, graph());
@@ -686,6 +757,7 @@ void Graph<F,E>::remove_edge(const FrameId& origin, const FrameId& target,
     }
     
     boost::remove_edge(originToTarget.first, *this);
+    pathRegistry.edgeRemoved(origin, target);
     notify(envire::core::EdgeRemovedEvent(origin, target));
     
     boost::remove_edge(targetToOrigin.first, *this);
@@ -715,12 +787,16 @@ void Graph<F,E>::removeEdgeFromTreeViews(vertex_descriptor origin, vertex_descri
     {
         if(view->edgeExists(origin, target))
             view->removeEdge(origin, target);
+        else
+            view->removeCrossEdge(origin, target);
     }    
 }
 
 template <class F, class E>
 void Graph<F,E>::addEdgeToTreeViews(edge_descriptor newEdge) const
 {
+    ENVIRE_STATS_TIMER(ADD_EDGE_TO_TREE_VIEWS);
+    ENVIRE_STATS_COUNT(TREE_VIEW_EDGE_UPDATES, subscribedTreeViews.size());
     for(TreeView* view : subscribedTreeViews)
     {
         addEdgeToTreeView(newEdge, view);
@@ -813,6 +889,7 @@ void Graph<F,E>::addEdgeToTreeView(edge_descriptor newEdge, TreeView* view) cons
         //and thus the bfs will not follow those edges.
         //the visitor will add those edges directly to the view
         TreeBuilderVisitor<Graph<F,E>> visitor(*view, *this);
+        ENVIRE_STATS_COUNT(TREE_VIEW_FILTERED_BFS, 1);
         breadthFirstSearch(fg, notInView, boost::visitor(visitor));
     }
 }
@@ -820,6 +897,7 @@ void Graph<F,E>::addEdgeToTreeView(edge_descriptor newEdge, TreeView* view) cons
 template <class F, class E>
 void Graph<F,E>::rebuildTreeViews() const
 {
+    ENVIRE_STATS_COUNT(TREE_VIEW_REBUILDS, subscribedTreeViews.size());
     for(TreeView* view : subscribedTreeViews)
     {
         view->clear();
@@ -1025,6 +1103,9 @@ void Graph<F,E>::regenerateLabelMap()
         const FrameId id = getFrameId(*it);
         _map[id] = *it;
     }
+    //copied or loaded vertices keep the indices of their source, which
+    //are not necessarily below max_vertex_index()
+    graph().renumber_vertex_indices();
 }
 
 template<class F, class E>
@@ -1053,7 +1134,7 @@ Path::Ptr Graph<F,E>::getPath(const FrameId& origin, const FrameId& target,
 {
     if(autoUpdating)
     {
-        return Path::Ptr(new Path(getFrames(origin, target), this));
+        return Path::Ptr(new Path(getFrames(origin, target), &pathRegistry));
     }
     else
     {
@@ -1075,13 +1156,28 @@ void Graph<F,E>::breadthFirstSearch(GRAPH& graph, const vertex_descriptor root,
 {
     // breadth first search uses a std::vector of default_color_type as default,
     // which is fine for graphs using boost::vecS. Since we are using listS,
-    // we need to provide a colormap:
-    std::unordered_map<vertex_descriptor, boost::default_color_type> colors;
-    auto colorMap = boost::make_assoc_property_map(colors);
-    // the alternative would be to provide a custom vertex_index_map which maps
-    // each vertex to an integer in [0, num_vertices(g))
+    // we need to provide a colormap. It is indexed by the vertex index that
+    // the directed_graph maintains for each vertex. All colors are white
+    // after the workspace has been borrowed, thus breadth_first_visit can
+    // be used instead of breadth_first_search which initializes every vertex.
+    TraversalWorkspace::Scope workspace(getVertexIndexBound());
+    WorkspaceColorMap<decltype(boost::get(boost::vertex_index, this->graph()))>
+        colorMap(*workspace, boost::get(boost::vertex_index, this->graph()));
+
+    boost::breadth_first_visit(graph, root,
+                               visitor.color_map(colorMap).buffer(workspace->getQueue()));
+}
 
-    boost::breadth_first_search(graph, root, visitor.color_map(colorMap));    
+template<class F, class E>
+std::size_t Graph<F,E>::getVertexIndex(const vertex_descriptor vd) const
+{
+    return boost::get(boost::vertex_index, graph(), vd);
+}
+
+template<class F, class E>
+std::size_t Graph<F,E>::getVertexIndexBound() const
+{
+    return graph().max_vertex_index();
 }
 
 
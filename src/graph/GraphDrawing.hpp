@@ -51,7 +51,7 @@ namespace envire { namespace core
                 << frame.getId()
                 <<   "|" << frame.calculateTotalItemCount() << "}";
                 
-            for(const auto& itemPair : frame.items)
+            for(const auto& itemPair : frame.getItemMap())
             {
                 std::string typeName = demangleTypeName(itemPair.first);
                 typeName = escapeAngleBraces(typeName);
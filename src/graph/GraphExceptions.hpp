@@ -36,6 +36,33 @@ namespace envire { namespace core
     
   
   
+    class InvalidSnapshotException : public std::exception
+    {
+    public:
+        explicit InvalidSnapshotException(const std::string& file, const std::string& reason) :
+          msg("Invalid snapshot " + file + ": " + reason) {}
+        virtual char const * what() const throw() { return msg.c_str(); }
+        const std::string msg;
+    };
+    
+    class InvalidJournalException : public std::exception
+    {
+    public:
+        explicit InvalidJournalException(const std::string& file, const std::string& reason) :
+          msg("Invalid journal " + file + ": " + reason) {}
+        virtual char const * what() const throw() { return msg.c_str(); }
+        const std::string msg;
+    };
+    
+    class GraphNotEmptyException : public std::exception
+    {
+    public:
+        explicit GraphNotEmptyException() :
+          msg("The graph has to be empty") {}
+        virtual char const * what() const throw() { return msg.c_str(); }
+        const std::string msg;
+    };
+    
     class InvalidPathException : public std::exception
     {
     public:
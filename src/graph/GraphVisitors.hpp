@@ -100,14 +100,15 @@ namespace envire { namespace core
 
 
     /**Visits every node in bfs order and stores the search tree in the provided map 
-     * @param GRAPH should be a boost graph of some kind*/
-    template <class GRAPH>
+     * @param GRAPH should be a boost graph of some kind
+     * @param VIEW the view that is filled, either TreeView or FlatTreeView*/
+    template <class GRAPH, class VIEW = TreeView>
     struct TreeBuilderVisitor : public boost::default_bfs_visitor
     {
         /** @param view The TreeView that should be filled
          *  @param graph The graph that is visited. The reference to the graph
          *               is needed to get the source and target of an edge.*/
-        TreeBuilderVisitor(TreeView& view, const GRAPH& graph) :
+        TreeBuilderVisitor(VIEW& view, const GRAPH& graph) :
             view(view), graph(graph) {}
 
         /**This is invoked on each edge as it becomes a member of 
@@ -136,7 +137,7 @@ namespace envire { namespace core
             view.addCrossEdge(boost::source(e, graph), boost::target(e, graph), e);
         }
         
-        TreeView& view;
+        VIEW& view;
         const GRAPH& graph;
     };
 
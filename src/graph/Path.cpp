@@ -25,34 +25,43 @@
 //
 
 #include "Path.hpp"
-#include <envire_core/events/EdgeEvents.hpp>
-#include <envire_core/events/GraphEventPublisher.hpp>
 
 
 namespace envire { namespace core
 {
   
-Path::Path(const std::vector<FrameId>& frames) : frames(frames), dirty(false), autoUpdating(false)
+Path::Path(const std::vector<FrameId>& frames) : frames(frames), dirty(false), registry(nullptr)
 {}
 
-Path::Path(const std::vector<FrameId>& frames, GraphEventPublisher* graph) : GraphEventDispatcher(graph),
-  frames(frames), dirty(false), autoUpdating(true)
+Path::Path(const std::vector<FrameId>& frames, PathRegistry* registry) :
+  frames(frames), dirty(false), registry(nullptr)
 {
-  createEdges(frames);
+  registry->add(this);
 }
 
-void Path::edgeRemoved(const EdgeRemovedEvent& e)
+Path::Path(const Path& other) : frames(other.frames), dirty(other.dirty), registry(nullptr)
 {
-  //we only get this event if we are subscribed to a graph. I.e. the graph manages this path.
-  assert(isAutoUpdating());
-  
-  if(isDirty())
-    return;
-  
-  if(edges.find(make_pair(e.origin, e.target)) != edges.end())
-  {
-    setDirty(true);
-  }
+  if(other.registry != nullptr)
+    other.registry->add(this);
+}
+
+Path& Path::operator=(const Path& other)
+{
+  if(this == &other)
+    return *this;
+  if(registry != nullptr)
+    registry->remove(this);
+  frames = other.frames;
+  dirty = other.dirty;
+  if(other.registry != nullptr)
+    other.registry->add(this);
+  return *this;
+}
+
+Path::~Path()
+{
+  if(registry != nullptr)
+    registry->remove(this);
 }
   
 const std::vector< FrameId >& Path::getFrames() const
@@ -86,15 +95,13 @@ bool Path::isEmpty() const
 
 bool Path::isAutoUpdating() const
 {
-  return autoUpdating;
+  return registry != nullptr;
 }
 
 void Path::unsubscribe()
 {
-  envire::core::GraphEventSubscriber::unsubscribe();
-  dirty = false; //dirty can never be true when not subscribed
-  edges.clear();
-  autoUpdating = false;
+  if(registry != nullptr)
+    registry->remove(this);
 }
 
 void Path::setDirty(const bool value)
@@ -104,21 +111,10 @@ void Path::setDirty(const bool value)
 
 void Path::setFrames(const std::vector<FrameId>& frames)
 {
-  this->frames = frames;
-  createEdges(frames);
-}
-
-void Path::createEdges(const std::vector< FrameId >& frames)
-{
-  edges.clear();
-  
-  if(frames.size() == 0) //loop below breakes for size == 0
-    return;
-  
-  for(int i = 0; i < ((int)frames.size()) - 1; ++i)
-  {
-    edges.emplace(frames[i], frames[i+1]);
-  }
+  if(registry != nullptr)
+    registry->update(this, frames);
+  else
+    this->frames = frames;
 }
 
 std::size_t Path::getSize() const
@@ -27,8 +27,8 @@
 #pragma once
 #include "GraphTypes.hpp"
 #include <envire_core/items/Transform.hpp>
-#include <envire_core/events/GraphEventDispatcher.hpp>
 #include <envire_core/graph/GraphTypes.hpp>
+#include <envire_core/graph/PathRegistry.hpp>
 #include <memory>
 
 namespace envire { namespace core
@@ -52,13 +52,15 @@ namespace envire { namespace core
    *  one that created the path.
    * 
    *  Paths may be auto updating (depending on what you specify on creation).
-   *  If a path is auto updating, it will notice when an edge on the path is 
-   *  removed from the graph and mark itself as dirty. The next time a dirty path
-   *  is used, it will try to update itself and find a new valid path from origin
-   *  to target.
+   *  If a path is auto updating, it is registered in the PathRegistry of the
+   *  graph, which marks it as dirty when an edge on the path is removed from
+   *  the graph. The next time a dirty path is used, it will try to update
+   *  itself and find a new valid path from origin to target.
    */
-  class Path : public GraphEventDispatcher
+  class Path
   {
+    friend class PathRegistry;
+
     //every template specialization of Graph is a friend
     template <class FRAME_PROP, class EDGE_PROP>
     friend class Graph;
@@ -69,6 +71,13 @@ namespace envire { namespace core
   public:
     
     using Ptr = std::shared_ptr<Path>;
+    
+    /**Copies are registered with the same graph as @p other */
+    Path(const Path& other);
+    Path& operator=(const Path& other);
+    
+    /**Unregisters the path from its graph */
+    ~Path();
       
     /**Returns the origin of this path.
      * @throw EmptyPathException if the path is empty*/
@@ -90,9 +99,17 @@ namespace envire { namespace core
     /**Returns true if the path is empty. False otherwise. */
     bool isEmpty() const;
   
-    /**Returns true if the path is subscribed to a graph and is autoupdating. False otherwise. */
+    /**Returns true if the path is registered with a graph and is autoupdating. False otherwise. */
     bool isAutoUpdating() const;
     
+    /**Unregisters the path from its graph. The path stops auto updating.
+     * Does nothing if the path is not auto updating.
+     * @deprecated Paths are no longer graph event subscribers. Request a
+     *             path that does not auto update from the graph instead.
+     *             The former subscribe() has been removed, a path can not
+     *             be registered again. */
+    void unsubscribe();
+    
     /** Returns the number of frames in this path*/
     std::size_t getSize() const;
     
@@ -111,35 +128,17 @@ namespace envire { namespace core
     Path(const std::vector<FrameId>& frames);
     
     /**Creates a path containing @p frames.
-     * The path is subscribed to @p graph and auto updates if the graph changes.*/
-    Path(const std::vector<FrameId>& frames, GraphEventPublisher* graph);
-    
-    /**overridden to reset pGraph when unsubscribed. Otherwise we might end up
-     * trying to update the path using a deleted graph.*/
-    virtual void unsubscribe() override;
-    
-    /**Checks whether the removed edge is part of this path, if yes dirties the path  */
-    virtual void edgeRemoved(const EdgeRemovedEvent& e) override;
+     * The path is registered in @p registry and auto updates if the graph changes.*/
+    Path(const std::vector<FrameId>& frames, PathRegistry* registry);
     
     void setDirty(const bool value);
     
-    void setEdges(const std::set<GraphTraits::edge_descriptor>& edges);
     void setFrames(const std::vector<FrameId>& frames);
     
   private:
-    
-    /*clear and re-create the edge set */
-    void createEdges(const std::vector<FrameId>& frames);
-    
     std::vector<FrameId> frames; // Index 0 is the origin, index n the target of the path.
-    
-    //all edges on the path. Used to quickly check if the path is affected when edges change.
-    //is empty when not subscribed to a graph.
-    //NOTE we can't use edge_descriptor here because it becomes invalid when the edge is removed
-    //     std::pair<FrameId, FrameId> is much slower to hash but is the only choice
-    std::unordered_set<std::pair<FrameId, FrameId>> edges;
     bool dirty; //If true, some edge on the path was removed and the path needs to be re-calculated
-    bool autoUpdating;
+    PathRegistry* registry; //The registry of the graph if auto updating, nullptr otherwise
   };
   
   
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "PathRegistry.hpp"
+#include "Path.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace envire { namespace core
+{
+
+PathRegistry::PathRegistry(const PathRegistry& other)
+{}
+
+PathRegistry& PathRegistry::operator=(const PathRegistry& other)
+{
+    return *this;
+}
+
+PathRegistry::~PathRegistry()
+{
+    for(Path* path : paths)
+    {
+        path->registry = nullptr;
+        path->dirty = false; //dirty can never be true when not auto updating
+    }
+}
+
+PathRegistry::EdgeKey PathRegistry::makeKey(const FrameId& a, const FrameId& b)
+{
+    return a < b ? EdgeKey(a, b) : EdgeKey(b, a);
+}
+
+std::size_t PathRegistry::edgeRemoved(const FrameId& a, const FrameId& b)
+{
+    const auto it = edgeToPaths.find(makeKey(a, b));
+    if(it == edgeToPaths.end())
+    {
+        return 0;
+    }
+    for(Path* path : it->second)
+    {
+        path->setDirty(true);
+    }
+    return it->second.size();
+}
+
+std::size_t PathRegistry::getPathCount(const FrameId& a, const FrameId& b) const
+{
+    const auto it = edgeToPaths.find(makeKey(a, b));
+    return it == edgeToPaths.end() ? 0 : it->second.size();
+}
+
+void PathRegistry::add(Path* path)
+{
+    if(paths.insert(path).second)
+    {
+        index(path);
+        path->registry = this;
+    }
+}
+
+void PathRegistry::remove(Path* path)
+{
+    if(paths.erase(path) > 0)
+    {
+        unindex(path);
+        path->registry = nullptr;
+    }
+}
+
+void PathRegistry::update(Path* path, const std::vector<FrameId>& frames)
+{
+    assert(paths.count(path) > 0);
+    unindex(path);
+    path->frames = frames;
+    index(path);
+}
+
+void PathRegistry::index(Path* path)
+{
+    for(std::size_t i = 1; i < path->frames.size(); ++i)
+    {
+        edgeToPaths[makeKey(path->frames[i - 1], path->frames[i])].push_back(path);
+    }
+}
+
+void PathRegistry::unindex(Path* path)
+{
+    for(std::size_t i = 1; i < path->frames.size(); ++i)
+    {
+        const auto it = edgeToPaths.find(makeKey(path->frames[i - 1], path->frames[i]));
+        assert(it != edgeToPaths.end());
+        std::vector<Path*>& edgePaths = it->second;
+        //index() added one entry per occurrence of the edge in the path
+        const auto pos = std::find(edgePaths.begin(), edgePaths.end(), path);
+        assert(pos != edgePaths.end());
+        *pos = edgePaths.back();
+        edgePaths.pop_back();
+        if(edgePaths.empty())
+        {
+            edgeToPaths.erase(it);
+        }
+    }
+}
+
+}}
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <envire_core/graph/GraphTypes.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace envire { namespace core
+{
+    class Path;
+
+    /** Keeps track of the auto updating paths of a graph.
+     *
+     *  The registry maintains an inverted index from each edge to the paths
+     *  that contain it. When an edge is removed, exactly the affected paths
+     *  are marked as dirty, instead of dispatching the event to every path.
+     *  The direction of an edge does not matter.
+     *
+     *  Each Graph owns a registry. Paths register on creation and
+     *  unregister on destruction. If the registry is destroyed first, all
+     *  registered paths stop auto updating.
+     */
+    class PathRegistry
+    {
+        friend class Path;
+    public:
+        PathRegistry() = default;
+
+        /**Creates an empty registry. Paths are ***not*** copied, they stay
+         * registered with the graph that created them. */
+        PathRegistry(const PathRegistry& other);
+
+        /**Does nothing. The registered paths stay registered. */
+        PathRegistry& operator=(const PathRegistry& other);
+
+        /**Detaches all registered paths */
+        ~PathRegistry();
+
+        /**Marks all paths that contain the edge between @p a and @p b as dirty.
+         * @return the number of paths that have been marked */
+        std::size_t edgeRemoved(const FrameId& a, const FrameId& b);
+
+        /** @return the number of registered paths */
+        std::size_t size() const { return paths.size(); }
+
+        /** @return the number of registered paths that contain the edge between @p a and @p b */
+        std::size_t getPathCount(const FrameId& a, const FrameId& b) const;
+
+    private:
+        using EdgeKey = std::pair<FrameId, FrameId>;
+
+        /** @return the key of the edge between @p a and @p b regardless of its direction */
+        static EdgeKey makeKey(const FrameId& a, const FrameId& b);
+
+        /**Registers @p path and indexes its edges */
+        void add(Path* path);
+
+        /**Unregisters @p path. Does nothing if it is not registered */
+        void remove(Path* path);
+
+        /**Replaces the frames of the registered @p path and re-indexes it */
+        void update(Path* path, const std::vector<FrameId>& frames);
+
+        void index(Path* path);
+        void unindex(Path* path);
+
+        std::unordered_map<EdgeKey, std::vector<Path*>> edgeToPaths;
+        std::unordered_set<Path*> paths;
+    };
+}}
@@ -52,6 +52,13 @@ namespace envire { namespace core
          * @throw UnknownFrameException if the @p origin or @p target does not exist*/
         const Transform getTransform(const FrameId& origin, const FrameId& target, const TreeView &view) const;
         const Transform getTransform(const vertex_descriptor origin, const vertex_descriptor target, const TreeView &view) const;
+
+        /** @return the transform between a and b using the tree structure of @p view.
+         *  Only walks up to the closest common ancestor of @p origin and @p target.
+         * @throw UnknownTransformException if @p origin or @p target is not part of @p view
+         * @throw UnknownFrameException if the @p origin or @p target does not exist*/
+        const Transform getTransform(const FrameId& origin, const FrameId& target, const FlatTreeView &view) const;
+        const Transform getTransform(const vertex_descriptor origin, const vertex_descriptor target, const FlatTreeView &view) const;
         /** @return the transform between source(edge) and target(edge) */
         const Transform getTransform(const edge_descriptor edge) const;
         
@@ -95,6 +102,10 @@ namespace envire { namespace core
     const Transform TransformGraph<F>::getTransform(const vertex_descriptor originVertex,
                                                     const vertex_descriptor targetVertex) const
     {
+        ENVIRE_STATS_TIMER(GET_TRANSFORM);
+        ENVIRE_TRACE_SCOPE("getTransform");
+        ENVIRE_TRACE_ARG("origin", getFrameId(originVertex));
+        ENVIRE_TRACE_ARG("target", getFrameId(targetVertex));
         if(num_edges() == 0)
         {
             throw UnknownTransformException(getFrameId(originVertex), getFrameId(targetVertex));
@@ -108,6 +119,7 @@ namespace envire { namespace core
             /** It is not a direct edge transformation **/
             Transform tf(base::Position::Zero(), base::Orientation::Identity()); //start with identity transform
             GraphBFSVisitor <vertex_descriptor>visit(targetVertex, this->graph());
+            ENVIRE_STATS_COUNT(TRANSFORM_BFS, 1);
 
             try
             {   
@@ -115,6 +127,8 @@ namespace envire { namespace core
 
             }catch(const FoundFrameException &e)
             {
+                //every discovered vertex except the root has a parent
+                ENVIRE_STATS_COUNT(TRANSFORM_BFS_VERTICES, visit.parent->size() + 1);
                 base::TransformWithCovariance &trans(tf.transform);
 
                 /** Compute the transformation **/
@@ -127,6 +141,7 @@ namespace envire { namespace core
                 return tf;
             }
             //ending up here means, that the breadth_first_search could not find a path from origin to target
+            ENVIRE_STATS_COUNT(TRANSFORM_BFS_VERTICES, visit.parent->size() + 1);
             throw UnknownTransformException(getFrameId(originVertex), getFrameId(targetVertex));
         }
 
@@ -188,6 +203,60 @@ namespace envire { namespace core
         return origin_tf * target_tf.inverse();
     }
     
+    template <class F>
+    const Transform TransformGraph<F>::getTransform(const vertex_descriptor originVertex,
+                                                    const vertex_descriptor targetVertex,
+                                                    const FlatTreeView &view) const
+    {
+        if (originVertex == targetVertex)
+        {
+            /* An identity transformation **/
+            return Transform(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+        }
+
+        FlatTreeView::Index o = view.getIndex(originVertex);
+        FlatTreeView::Index t = view.getIndex(targetVertex);
+        if(o == FlatTreeView::NO_INDEX || t == FlatTreeView::NO_INDEX)
+        {
+            throw UnknownTransformException(getFrameId(originVertex), getFrameId(targetVertex));
+        }
+
+        base::TransformWithCovariance origin_tf = base::TransformWithCovariance::Identity();
+        base::TransformWithCovariance target_tf = base::TransformWithCovariance::Identity();
+
+        auto stepUp = [&](FlatTreeView::Index& i, base::TransformWithCovariance& tf)
+        {
+            const FlatTreeView::Index parent = view.getParentIndex(i);
+            EdgePair pair(boost::edge(view.getVertex(i), view.getVertex(parent), *this));
+            if (pair.second)
+            {
+                tf = tf * (*this)[pair.first].transform;
+            }
+            i = parent;
+        };
+
+        /** Walk both vertices up to their closest common ancestor **/
+        while(view.getDepth(o) > view.getDepth(t))
+            stepUp(o, origin_tf);
+        while(view.getDepth(t) > view.getDepth(o))
+            stepUp(t, target_tf);
+        while(o != t)
+        {
+            stepUp(o, origin_tf);
+            stepUp(t, target_tf);
+        }
+
+        return origin_tf * target_tf.inverse();
+    }
+
+    template <class F>
+    const Transform TransformGraph<F>::getTransform(const FrameId& origin, const FrameId& target, const FlatTreeView &view) const
+    {
+        const vertex_descriptor originVertex = getVertex(origin);//will throw
+        const vertex_descriptor targetVertex = getVertex(target); //will throw
+        return getTransform(originVertex, targetVertex, view);
+    }
+
     template <class F>
     const Transform TransformGraph<F>::getTransform(const std::shared_ptr<Path> path) const
     {
@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <envire_core/graph/TraversalWorkspace.hpp>
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace envire { namespace core
+{
+namespace
+{
+    /**The workspaces of one thread. Workspaces below depth are in use. */
+    struct WorkspaceStack
+    {
+        std::vector<std::unique_ptr<TraversalWorkspace>> workspaces;
+        std::size_t depth = 0;
+    };
+
+    WorkspaceStack& localStack()
+    {
+        static thread_local WorkspaceStack stack;
+        return stack;
+    }
+}
+
+TraversalWorkspace::Scope::Scope(const std::size_t numIndices)
+{
+    WorkspaceStack& stack = localStack();
+    if(stack.depth == stack.workspaces.size())
+    {
+        stack.workspaces.emplace_back(new TraversalWorkspace());
+    }
+    workspace = stack.workspaces[stack.depth].get();
+    ++stack.depth;
+    workspace->reset(numIndices);
+}
+
+TraversalWorkspace::Scope::~Scope()
+{
+    WorkspaceStack& stack = localStack();
+    assert(stack.depth > 0);
+    assert(stack.workspaces[stack.depth - 1].get() == workspace);
+    --stack.depth;
+}
+
+void TraversalWorkspace::reset(const std::size_t numIndices)
+{
+    if(stamps.size() < numIndices)
+    {
+        stamps.resize(numIndices, 0);
+        colors.resize(numIndices, boost::white_color);
+    }
+    ++epoch;
+    if(epoch == 0)
+    {
+        //the epoch wrapped around, old stamps might match again
+        std::fill(stamps.begin(), stamps.end(), 0);
+        epoch = 1;
+    }
+    queue.clear();
+}
+
+}}
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <envire_core/graph/GraphTypes.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace envire { namespace core
+{
+    /** Scratch memory for graph traversals that is reused between calls.
+     *
+     *  Contains a color array that is indexed by the vertex index of the
+     *  graph and a bfs queue. Colors are cleared in O(1) by incrementing an
+     *  epoch. Each thread owns a stack of workspaces, use TraversalWorkspace::Scope
+     *  to borrow one. Nested traversals (e.g. a traversal started from within
+     *  a visitor) borrow the next workspace of the stack.
+     *
+     *  Graph::breadthFirstSearch() uses the workspace internally. Custom
+     *  traversals can use it as well, @see Graph::getVertexIndex() */
+    class TraversalWorkspace
+    {
+    public:
+        /**A fifo buffer that keeps its memory between traversals.
+         * Fulfills the buffer concept of boost::breadth_first_search. */
+        class Queue
+        {
+        public:
+            using value_type = GraphTraits::vertex_descriptor;
+            void push(const value_type& vd) { data.push_back(vd); }
+            void pop() { ++head; }
+            value_type& top() { return data[head]; }
+            const value_type& top() const { return data[head]; }
+            bool empty() const { return head == data.size(); }
+            std::size_t size() const { return data.size() - head; }
+            void clear() { data.clear(); head = 0; }
+        private:
+            std::vector<value_type> data;
+            std::size_t head = 0;
+        };
+
+        /**Borrows the next free workspace of the calling thread and prepares
+         * it for a traversal over @p numIndices vertex indices.
+         * The workspace is returned on destruction. */
+        class Scope
+        {
+        public:
+            explicit Scope(const std::size_t numIndices);
+            ~Scope();
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            TraversalWorkspace& operator*() const { return *workspace; }
+            TraversalWorkspace* operator->() const { return workspace; }
+        private:
+            TraversalWorkspace* workspace;
+        };
+
+        boost::default_color_type getColor(const std::size_t index) const
+        {
+            return stamps[index] == epoch ? colors[index] : boost::white_color;
+        }
+
+        void setColor(const std::size_t index, const boost::default_color_type color)
+        {
+            stamps[index] = epoch;
+            colors[index] = color;
+        }
+
+        Queue& getQueue() { return queue; }
+
+    private:
+        /**Resets all colors to white and clears the queue */
+        void reset(const std::size_t numIndices);
+
+        std::vector<uint32_t> stamps;
+        std::vector<boost::default_color_type> colors;
+        uint32_t epoch = 0;
+        Queue queue;
+    };
+
+    /**A color map for boost graph algorithms that is backed by a TraversalWorkspace.
+     * @param INDEX_MAP a readable property map from vertex_descriptor to the
+     *                  vertex index of the graph. */
+    template <class INDEX_MAP>
+    struct WorkspaceColorMap
+    {
+        using key_type = GraphTraits::vertex_descriptor;
+        using value_type = boost::default_color_type;
+        using reference = boost::default_color_type;
+        using category = boost::read_write_property_map_tag;
+
+        WorkspaceColorMap(TraversalWorkspace& workspace, const INDEX_MAP& index) :
+            workspace(&workspace), index(index) {}
+
+        TraversalWorkspace* workspace;
+        INDEX_MAP index;
+    };
+
+    template <class INDEX_MAP>
+    inline boost::default_color_type get(const WorkspaceColorMap<INDEX_MAP>& map,
+                                         const GraphTraits::vertex_descriptor vd)
+    {
+        return map.workspace->getColor(boost::get(map.index, vd));
+    }
+
+    template <class INDEX_MAP>
+    inline void put(const WorkspaceColorMap<INDEX_MAP>& map,
+                    const GraphTraits::vertex_descriptor vd,
+                    const boost::default_color_type color)
+    {
+        map.workspace->setColor(boost::get(map.index, vd), color);
+    }
+}}
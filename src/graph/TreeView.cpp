@@ -25,6 +25,9 @@
 //
 
 #include <envire_core/graph/TreeView.hpp>
+#include <envire_core/util/GraphStats.hpp>
+
+#include <algorithm>
 
 namespace envire { namespace core
 {
@@ -59,6 +62,8 @@ TreeView::TreeView(TreeView&& other) noexcept : crossEdges(std::move(other.cross
     }
     crossEdgeAdded.swap(other.crossEdgeAdded);
     edgeAdded.swap(other.edgeAdded);
+    edgeRemoved.swap(other.edgeRemoved);
+    crossEdgeRemoved.swap(other.crossEdgeRemoved);
 }
 
 
@@ -146,9 +151,55 @@ void TreeView::addCrossEdge(const GraphTraits::vertex_descriptor origin,
                             const GraphTraits::vertex_descriptor target,
                             const GraphTraits::edge_descriptor edge)
 {
+    tree[origin].crossEdgeVertices[target] = crossEdges.size();
+    tree[target].crossEdgeVertices[origin] = crossEdges.size();
     crossEdges.emplace_back(origin, target, edge);
     crossEdgeAdded(crossEdges.back());
 }
+
+bool TreeView::crossEdgeExists(const vertex_descriptor a, const vertex_descriptor b) const
+{
+    const auto it = tree.find(a);
+    if(it == tree.end())
+    {
+        return false;
+    }
+    return it->second.crossEdgeVertices.count(b) > 0;
+}
+
+void TreeView::eraseCrossEdge(std::size_t i)
+{
+    const CrossEdge& edge = crossEdges[i];
+    tree.at(edge.origin).crossEdgeVertices.erase(edge.target);
+    tree.at(edge.target).crossEdgeVertices.erase(edge.origin);
+    if(i + 1 != crossEdges.size())
+    {
+        //move the last cross-edge into the gap and update its position
+        crossEdges[i] = crossEdges.back();
+        const CrossEdge& moved = crossEdges[i];
+        tree.at(moved.origin).crossEdgeVertices[moved.target] = i;
+        tree.at(moved.target).crossEdgeVertices[moved.origin] = i;
+    }
+    crossEdges.pop_back();
+}
+
+bool TreeView::removeCrossEdge(vertex_descriptor a, vertex_descriptor b)
+{
+    const auto it = tree.find(a);
+    if(it == tree.end())
+    {
+        return false;
+    }
+    const auto edge = it->second.crossEdgeVertices.find(b);
+    if(edge == it->second.crossEdgeVertices.end())
+    {
+        return false;
+    }
+    const CrossEdge removed = crossEdges[edge->second];
+    eraseCrossEdge(edge->second);
+    crossEdgeRemoved(removed);
+    return true;
+}
 void TreeView::addEdge(vertex_descriptor origin, vertex_descriptor target)
 {
     tree[origin].children.insert(target);
@@ -160,38 +211,28 @@ void TreeView::addEdge(vertex_descriptor origin, vertex_descriptor target)
 
 void TreeView::removeEdge(vertex_descriptor origin, vertex_descriptor target)
 {
+  ENVIRE_STATS_TIMER(TREE_VIEW_REMOVE_EDGE);
   
 
   /**Algorithm:
-   * (1) bfs visit the sub-tree that will be removed. For each visited vertex:
-   * (2.1) Check if a cross-edge is connected to the vertex.
-   * (2.2) If yes, check if the cross-edge is already part of S. If it is, 
-   *       remove it from S. otherwise add it.
-   * (3) S now contains all cross-edges that connect the sub-tree to the
-   *     graph.
-   * (4) Remove the sub-tree from the graph
-   * (5) If S is not empty, generate a new sub-tree with S[0] as root and
-   *     add it to the tree. 
+   * (1) bfs visit the sub-tree that will be removed and remember its vertices.
+   * (2) Collect the cross-edges of the sub-tree from the per vertex
+   *     cross-edge index and remove them from crossEdges. The ones that leave
+   *     the sub-tree still connect it to the tree.
+   * (3) If such a cross-edge exists, re-root the sub-tree at its vertex.
+   *     Re-rooting a tree is a bfs over the undirected tree, starting at the
+   *     new root.
+   * (4) Remove the sub-tree from the tree
+   * (5) Add the re-rooted sub-tree and the remaining cross-edges again.
    * */
   
-  
-  //a map to map from vertex_descriptor to edge_descriptor.
-  //It is a multimap because multiple cross-edges might be connected
-  //to the same vertex.
-  std::multimap<vertex_descriptor, std::vector<CrossEdge>::iterator> vertexToCrossEdge;
-  for(std::vector<CrossEdge>::iterator edge = crossEdges.begin(); edge != crossEdges.end(); ++edge)
-  {
-      vertexToCrossEdge.emplace(edge->origin, edge);
-      vertexToCrossEdge.emplace(edge->target, edge);
-  }
-  
-  vertex_descriptor realTarget;
+  vertex_descriptor realTarget = GraphTraits::null_vertex();
   //figure out which of the vertices is acutally the origin in the tree
-  if(tree[target].parent == origin)
+  if(tree.at(target).parent == origin)
   {
       realTarget = target;
   }
-  else if(tree[origin].parent == target)
+  else if(tree.at(origin).parent == target)
   {
       realTarget = origin;
   }
@@ -202,32 +243,84 @@ void TreeView::removeEdge(vertex_descriptor origin, vertex_descriptor target)
       assert(false);
   }
   
-  //will contain the list of cross-edges that are connected to the sub-tree
-  std::set<std::vector<CrossEdge>::iterator> treeLeavingCrossEdges;
   //stores all visited vertices that should be removed later
   std::vector<vertex_descriptor> vertices;
-  
+  std::unordered_set<vertex_descriptor> subTree;
+  //positions of the cross-edges that are connected to the sub-tree
+  std::vector<std::size_t> crossEdgeIndices;
   visitBfs(realTarget, [&](vertex_descriptor node, vertex_descriptor parent)
   {
       vertices.push_back(node);
-      auto range = vertexToCrossEdge.equal_range(node);
-      for (auto it = range.first; it != range.second; ++it)
+      subTree.insert(node);
+      for(const auto& crossEdge : tree[node].crossEdgeVertices)
+          crossEdgeIndices.push_back(crossEdge.second);
+  });
+  
+  ENVIRE_STATS_COUNT(TREE_VIEW_REMOVED_VERTICES, vertices.size());
+
+  //cross-edges inside the sub-tree have been found from both ends.
+  //Sorting also keeps them in the order of crossEdges.
+  std::sort(crossEdgeIndices.begin(), crossEdgeIndices.end());
+  crossEdgeIndices.erase(std::unique(crossEdgeIndices.begin(), crossEdgeIndices.end()),
+                         crossEdgeIndices.end());
+
+  //all cross-edges that are connected to the sub-tree
+  std::vector<CrossEdge> subTreeCrossEdges;
+  subTreeCrossEdges.reserve(crossEdgeIndices.size());
+  for(const std::size_t i : crossEdgeIndices)
+      subTreeCrossEdges.push_back(crossEdges[i]);
+  //erase back to front, the last cross-edge that eraseCrossEdge moves is
+  //then never one that still has to be erased
+  for(auto i = crossEdgeIndices.rbegin(); i != crossEdgeIndices.rend(); ++i)
+      eraseCrossEdge(*i);
+
+  //the cross-edge that is used to re-attach the sub-tree, i.e. the first one
+  //that leaves it
+  const CrossEdge* attachEdge = nullptr;
+  for(const CrossEdge& edge : subTreeCrossEdges)
+  {
+      if((subTree.count(edge.origin) > 0) != (subTree.count(edge.target) > 0))
       {
-          std::vector<CrossEdge>::iterator crossEdge = it->second;
-          if(treeLeavingCrossEdges.find(crossEdge) == treeLeavingCrossEdges.end())
-          {
-              treeLeavingCrossEdges.insert(crossEdge);
-          } 
-          else
-          {
-              //if we found an edge for the second time it is internal
-              //in the sub-tree and should be removed as well.
-              treeLeavingCrossEdges.erase(crossEdge);
-              crossEdges.erase(crossEdge);
-          }
+          attachEdge = &edge;
+          break;
       }
-  });
+  }
+  for(const CrossEdge& edge : subTreeCrossEdges)
+      crossEdgeRemoved(edge);
+
+  //the edges of the re-rooted sub-tree in bfs order
+  std::vector<std::pair<vertex_descriptor, vertex_descriptor>> reattachedEdges;
   
+  if(attachEdge != nullptr)
+  {
+      const vertex_descriptor newRoot = subTree.count(attachEdge->origin) > 0 ?
+                                        attachEdge->origin : attachEdge->target;
+      std::unordered_set<vertex_descriptor> visited;
+      std::deque<vertex_descriptor> nodesToVisit;
+      visited.insert(newRoot);
+      nodesToVisit.push_back(newRoot);
+      while(!nodesToVisit.empty())
+      {
+          const vertex_descriptor current = nodesToVisit.front();
+          nodesToVisit.pop_front();
+          const VertexRelation& relation = tree.at(current);
+          auto visit = [&](vertex_descriptor next)
+          {
+              if(visited.insert(next).second)
+              {
+                  reattachedEdges.emplace_back(current, next);
+                  nodesToVisit.push_back(next);
+              }
+          };
+          //the edge between realTarget and its parent is the one that is removed
+          if(current != realTarget)
+              visit(relation.parent);
+          for(const vertex_descriptor child : relation.children)
+              visit(child);
+      }
+      ENVIRE_STATS_COUNT(TREE_VIEW_REATTACHED_VERTICES, vertices.size());
+  }
+
   //remove vertices in reverse order to ensure that the parent is still in the
   //tree when the event is emitted.
   while(vertices.size() > 0)
@@ -244,12 +337,23 @@ void TreeView::removeEdge(vertex_descriptor origin, vertex_descriptor target)
       edgeRemoved(parent, node);
   }
   
-  //TODO if cross-edge is present, readd new tree
-  if(treeLeavingCrossEdges.size() > 0)
+  if(attachEdge != nullptr)
   {
-      throw std::runtime_error("NOT IMPLEMENTED");
+      const bool originInSubTree = subTree.count(attachEdge->origin) > 0;
+      if(originInSubTree)
+          addEdge(attachEdge->target, attachEdge->origin);
+      else
+          addEdge(attachEdge->origin, attachEdge->target);
+      
+      for(const auto& edge : reattachedEdges)
+          addEdge(edge.first, edge.second);
+      
+      for(const CrossEdge& edge : subTreeCrossEdges)
+      {
+          if(&edge != attachEdge)
+              addCrossEdge(edge.origin, edge.target, edge.edge);
+      }
   }
-
 }
 
 void TreeView::addRoot(vertex_descriptor root)
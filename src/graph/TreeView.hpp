@@ -39,9 +39,9 @@ namespace envire { namespace core
     {
         GraphTraits::vertex_descriptor parent; /**<can be null_vertex */
         std::unordered_set<GraphTraits::vertex_descriptor> children;
-        
-        
-        
+        /**vertices that are connected to this vertex by a cross-edge, mapped to
+         * the position of that cross-edge in TreeView::crossEdges */
+        std::unordered_map<GraphTraits::vertex_descriptor, std::size_t> crossEdgeVertices;
     };
 
     /**A map that shows the vertex information (parent and children) of the vertices in a tree.
@@ -173,9 +173,20 @@ namespace envire { namespace core
          * emitted starting from the deeps edge in the tree, i.e. you can be sure
          * that the parent still exists in the tree when handling the event.
          *
-         * If cross-edges exist that point into the sub-tree that is beeing removed,
-         * the method will return*/
+         * If cross-edges connect the sub-tree to the rest of the tree, the
+         * sub-tree is re-attached through one of them afterwards. The sub-tree
+         * is re-rooted at the vertex of that cross-edge and added again,
+         * emitting edgeAdded in bfs order. The remaining cross-edges of the
+         * sub-tree are added again as well, emitting crossEdgeAdded.*/
         void removeEdge(GraphTraits::vertex_descriptor origin, GraphTraits::vertex_descriptor target);
+
+        /**Removes the cross-edge between @p a and @p b, regardless of its direction.
+         * Emits crossEdgeRemoved.
+         * @return false if there is no cross-edge between @p a and @p b */
+        bool removeCrossEdge(GraphTraits::vertex_descriptor a, GraphTraits::vertex_descriptor b);
+
+        /**Returns true if a cross-edge between @p a and @p b exists in the view */
+        bool crossEdgeExists(const GraphTraits::vertex_descriptor a, const GraphTraits::vertex_descriptor b) const;
         
         /** Returns the parent of @p node. Returns null_vertex if there is no parent
          * @throw std::exception if @p node is not in the tree*/
@@ -199,13 +210,19 @@ namespace envire { namespace core
         boost::signals2::signal<void (GraphTraits::vertex_descriptor origin,
                                       GraphTraits::vertex_descriptor target)> edgeRemoved;
 
+        /**Is emitted when a cross-edge is removed from the view.
+         * This includes the cross-edges of a sub-tree that is removed by
+         * removeEdge(). They are emitted before the sub-tree is removed.*/
+        boost::signals2::signal<void (const CrossEdge&)> crossEdgeRemoved;
+
         /* The edges, that had to be removed to create the tree.
          * I.e. All edges that lead to a vertex that has already been discovered.
          * This does **not** include back-edges. I.e. edges that lead to a vertex that
          * has already been visited.
          * @note The TransformGraph always contains two edges between connected nodes (the edge and the inverse edge)
          *       However only one of them will be in the crossEdges. The other one automatically becomes a back-edge 
-         *       and is ignored. */
+         *       and is ignored.
+         * @note Removing a cross-edge moves the last cross-edge to its position. */
         std::vector<CrossEdge> crossEdges;
         
         /**The root node of this TreeView */
@@ -213,5 +230,9 @@ namespace envire { namespace core
         VertexRelationMap tree;   
     protected:
         TreeUpdatePublisher* publisher = nullptr;/*< Used for automatic unsubscribing in dtor */
+    private:
+        /**Removes crossEdges[i] from crossEdges and from the index of its vertices.
+         * The last cross-edge is moved to position @p i. Does not emit crossEdgeRemoved. */
+        void eraseCrossEdge(std::size_t i);
     };
 }}
\ No newline at end of file
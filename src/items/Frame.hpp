@@ -29,22 +29,59 @@
 
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/version.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <vector>
 #include <string>
 #include <sstream>
 #include <unordered_map>
 #include <typeindex>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
 #include <glog/logging.h>
     
 #include "ItemBase.hpp"
+#include "ItemStore.hpp"
 #include "RandomGenerator.hpp"
 #include <boost_serialization/BoostTypes.hpp>
 #include <boost_serialization/DynamicSizeSerialization.hpp>
 #include <envire_core/serialization/Serialization.hpp>
+#include <envire_core/serialization/ItemLoadFilter.hpp>
 #include <envire_core/util/Demangle.hpp>
 
 namespace envire { namespace core
 {
+    class Frame;
+    
+    /**Items of a frame that have not been deserialized, yet.
+     * Is used to load items lazily on first access, e.g. by GraphSnapshot. */
+    class PendingItems
+    {
+    public:
+        virtual ~PendingItems() {}
+        
+        /**Deserializes the pending items and adds them to @p frame */
+        virtual void load(Frame& frame) = 0;
+    };
+    
+    /**Item records that have been read from an archive, but are
+     * deserialized on first access. Items of archive layouts that cannot be
+     * deferred are loaded immediately and are only added on first access.
+     * @see ItemLoadFilter */
+    class DeferredItems : public PendingItems
+    {
+    public:
+        DeferredItems(std::vector<ItemLoadFilter::Record>&& records,
+                      std::vector<std::vector<ItemBase::Ptr>>&& loaded) :
+            records(std::move(records)), loaded(std::move(loaded)) {}
+        
+        virtual void load(Frame& frame);
+        
+    private:
+        std::vector<ItemLoadFilter::Record> records;
+        std::vector<std::vector<ItemBase::Ptr>> loaded;
+    };
+    
     /**A Frame is attached to each vertex in the TransformGraph.
      * It holds a lists of arbitrary items organized by item type. 
      * The Frame itself is a POD. The logic for manipulating Frames is part of
@@ -56,16 +93,65 @@ namespace envire { namespace core
 
         using ItemList = std::vector<ItemBase::Ptr>;
         using ItemMap = std::unordered_map<std::type_index, ItemList>;
-        //contains all items that have been added to the frame sorted by type
+        //contains all items that have been added to the frame sorted by type.
+        //Use getItemMap() to access the items, unless you know that the
+        //frame has no pending items.
         ItemMap items;
 
+        using ItemStoreMap = std::unordered_map<std::type_index, ItemStoreBase::Ptr>;
+        //contains the contiguous item stores of this frame sorted by item type.
+        //Stores are opt-in, see EnvireGraph::enableItemStore().
+        ItemStoreMap stores;
+
     public:
         
         Frame() : id("envire::core::default_frame_id"){}
       
         Frame(const FrameId& id): id(id) {}
 
-        ~Frame(){ this->items.clear(); }
+        /**Items are shared between copies, while item stores are deep copied
+         * because they own their items. */
+        Frame(const Frame& other) : id(other.id), items(other.getItemMap())
+        {
+            copyStores(other);
+        }
+
+        Frame& operator=(const Frame& other)
+        {
+            if(this != &other)
+            {
+                id = other.id;
+                items = other.getItemMap();
+                setPendingItems(boost::shared_ptr<PendingItems>());
+                copyStores(other);
+            }
+            return *this;
+        }
+
+        /**The mutex is not moved, each frame has its own */
+        Frame(Frame&& other) : id(std::move(other.id)), items(std::move(other.items)),
+                               stores(std::move(other.stores)),
+                               pendingItems(std::move(other.pendingItems)),
+                               pending(other.pending.load())
+        {
+            other.pending = false;
+        }
+
+        Frame& operator=(Frame&& other)
+        {
+            if(this != &other)
+            {
+                id = std::move(other.id);
+                items = std::move(other.items);
+                stores = std::move(other.stores);
+                pendingItems = std::move(other.pendingItems);
+                pending = other.pending.load();
+                other.pending = false;
+            }
+            return *this;
+        }
+
+        ~Frame(){ this->items.clear(); this->stores.clear(); }
 
         /**@brief setFrame
         *
@@ -79,14 +165,85 @@ namespace envire { namespace core
         */
         const FrameId& getId() const { return id; }
         
-        /**Returns the total number of items in this frame */
+        /** @return the items of this frame. Pending items are loaded first. */
+        ItemMap& getItemMap()
+        {
+            loadPendingItems();
+            return items;
+        }
+        
+        const ItemMap& getItemMap() const
+        {
+            loadPendingItems();
+            return items;
+        }
+        
+        /** @return the number of items of @p type including the items in
+         *          the item store of @p type */
+        std::size_t getItemCount(const std::type_index& type) const
+        {
+            std::size_t count = 0;
+            const ItemMap& items = getItemMap();
+            const ItemMap::const_iterator list = items.find(type);
+            if(list != items.end())
+                count += list->second.size();
+            const ItemStoreMap::const_iterator store = stores.find(type);
+            if(store != stores.end())
+                count += store->second->size();
+            return count;
+        }
+        
+        /** @return true if the frame contains items that have not been
+         *          deserialized, yet */
+        bool hasPendingItems() const { return pending.load(std::memory_order_acquire); }
+        
+        /**Sets the items that should be loaded on first access.
+         * Replaces previously set pending items. */
+        void setPendingItems(const boost::shared_ptr<PendingItems>& pendingItems)
+        {
+            std::lock_guard<std::mutex> lock(lazyMutex);
+            this->pendingItems = pendingItems;
+            pending.store(pendingItems != nullptr, std::memory_order_release);
+        }
+        
+        /**Deserializes the pending items (if any).
+         * Is thread-safe, concurrent readers wait until the items are loaded.
+         * If loading fails, the items of the frame are left unchanged and
+         * the pending items are kept. */
+        void loadPendingItems() const
+        {
+            if(!pending.load(std::memory_order_acquire))
+                return;
+            std::lock_guard<std::mutex> lock(lazyMutex);
+            if(!pendingItems)
+                return;
+            //load into a temporary frame, thus a failing loader does not
+            //leave a partially loaded frame behind
+            Frame loaded(id);
+            pendingItems->load(loaded);
+            ItemMap& target = const_cast<Frame&>(*this).items;
+            for(auto& itemPair : loaded.items)
+            {
+                ItemList& list = target[itemPair.first];
+                list.insert(list.end(), itemPair.second.begin(), itemPair.second.end());
+            }
+            pendingItems.reset();
+            pending.store(false, std::memory_order_release);
+        }
+        
+        /**Returns the total number of items in this frame, including the
+         * items in the item stores */
         std::size_t calculateTotalItemCount() const 
         {
             std::size_t count = 0;
-            for(const auto& itemPair : items)
+            for(const auto& itemPair : getItemMap())
             {
               count += itemPair.second.size();
             }
+            for(const auto& storePair : stores)
+            {
+              count += storePair.second->size();
+            }
             return count;
         }
         
@@ -111,18 +268,32 @@ namespace envire { namespace core
         std::vector<std::type_index> getItemTypes() const
         {
             std::vector<std::type_index> result;
-            for(const auto& itemPair : items)
+            for(const auto& itemPair : getItemMap())
             {
               result.push_back(itemPair.first);
             }
             return result;
         }
         
+        /** @return A list of all item types that have an item store in this frame */
+        std::vector<std::type_index> getItemStoreTypes() const
+        {
+            std::vector<std::type_index> result;
+            for(const auto& storePair : stores)
+            {
+              result.push_back(storePair.first);
+            }
+            return result;
+        }
+        
         /**Visits all items in this frame.
+         * Items that live in an item store are materialized before being
+         * passed to @p func. I.e. @p func receives a copy.
          * @param func should have an operator(const ItemBase::Ptr)*/
         template <class T>
         void visitItems(T func) const
         {
+            const ItemMap& items = getItemMap();
             for(ItemMap::const_iterator it = items.begin(); it != items.end(); ++it)
             {
                 const ItemList& list = it->second;
@@ -131,24 +302,136 @@ namespace envire { namespace core
                     func(item);
                 }
             }
+            for(const auto& storePair : stores)
+            {
+                const ItemStoreBase& store = *storePair.second;
+                for(std::size_t i = 0; i < store.size(); ++i)
+                {
+                    func(store.materialize(i, id));
+                }
+            }
+        }
+        
+        /**@return a copy of the item map that additionally contains
+         *         materialized copies of all items in the item stores */
+        ItemMap getMaterializedItems() const
+        {
+            ItemMap result(getItemMap());
+            for(const auto& storePair : stores)
+            {
+                const ItemStoreBase& store = *storePair.second;
+                if(store.empty())
+                    continue;
+                ItemList& list = result[storePair.first];
+                list.reserve(list.size() + store.size());
+                for(std::size_t i = 0; i < store.size(); ++i)
+                {
+                    list.push_back(store.materialize(i, id));
+                }
+            }
+            return result;
         }
 
     private:
+        /**Items that are loaded on first access */
+        mutable boost::shared_ptr<PendingItems> pendingItems;
+        /**true while pendingItems is set. Allows checking for pending items
+         * without locking */
+        mutable std::atomic<bool> pending{false};
+        /**Guards the lazily initialized members */
+        mutable std::mutex lazyMutex;
+        
+        void copyStores(const Frame& other)
+        {
+            stores.clear();
+            for(const auto& storePair : other.stores)
+            {
+                stores.emplace(storePair.first, storePair.second->clone());
+            }
+        }
+
         /**Grants access to boost serialization */
         friend class boost::serialization::access;
 
-        /**Serializes the members of this class*/
+        /**Serializes the members of this class.
+         * Items of the item stores are stored as regular items, thus the
+         * archive format does not depend on the storage mode. After loading
+         * they are part of the regular item lists. */
         template<class Archive>
-        void serialize(Archive & ar, const unsigned int version)
+        void save(Archive & ar, const unsigned int version) const
         {
-            ar & BOOST_SERIALIZATION_NVP(id);
-            ar & BOOST_SERIALIZATION_NVP(items);
+            ar << BOOST_SERIALIZATION_NVP(id);
+            if(stores.empty())
+            {
+                const ItemMap& items = getItemMap();
+                ar << BOOST_SERIALIZATION_NVP(items);
+            }
+            else
+            {
+                const ItemMap materialized = getMaterializedItems();
+                ar << boost::serialization::make_nvp("items", materialized);
+            }
         }
 
+        template<class Archive>
+        void load(Archive & ar, const unsigned int version)
+        {
+            stores.clear();
+            setPendingItems(boost::shared_ptr<PendingItems>());
+            ar >> BOOST_SERIALIZATION_NVP(id);
+            ItemLoadFilter& filter = ar.template get_helper<ItemLoadFilter>(ItemLoadFilter::helperId());
+            filter.beginFrame(id);
+            ar >> BOOST_SERIALIZATION_NVP(items);
+            if(!filter.deferred.empty() || !filter.deferredItems.empty())
+            {
+                setPendingItems(boost::make_shared<DeferredItems>(std::move(filter.deferred),
+                                                                  std::move(filter.deferredItems)));
+                filter.deferred.clear();
+                filter.deferredItems.clear();
+            }
+        }
+
+        BOOST_SERIALIZATION_SPLIT_MEMBER()
+
     };
+    
+    inline void DeferredItems::load(Frame& frame)
+    {
+        //frame is a temporary frame, the members are kept in case of an
+        //exception, see Frame::loadPendingItems()
+        std::vector<Frame::ItemList> lists(loaded);
+        for(const ItemLoadFilter::Record& record : records)
+        {
+            Serialization::HandlePtr handle;
+            if(!Serialization::resolveHandle(record.class_name, handle) || !handle)
+            {
+                LOG(ERROR) << "No serialization handle available for items of type " << record.class_name
+                           << ". The deferred items of frame " << frame.getId() << " have been dropped.";
+                continue;
+            }
+            Frame::ItemList item_list;
+            if(!Serialization::loadItemsFromBinary(record.data.data(), record.data.size(),
+                                                   handle, record.count, item_list))
+                LOG(ERROR) << "Failed to load deferred items of frame " << frame.getId();
+            lists.push_back(std::move(item_list));
+        }
+        for(const Frame::ItemList& item_list : lists)
+        {
+            if(!item_list.empty())
+            {
+                Frame::ItemList& target = frame.items[item_list.front()->getTypeIndex()];
+                target.insert(target.end(), item_list.begin(), item_list.end());
+            }
+        }
+    }
 }}
 
-BOOST_CLASS_VERSION(envire::core::Frame::ItemMap, 1)
+/**Version 2 references the class name of each item list using the
+ * ClassNameDictionary of the archive instead of storing it per item.
+ * Version 3 stores the items of each list as a length-prefixed record in
+ * binary archives, thus lists can be skipped while loading. Text archives
+ * store the items inline like version 2. */
+BOOST_CLASS_VERSION(envire::core::Frame::ItemMap, 3)
 
 namespace boost { namespace serialization
 {
@@ -180,6 +463,8 @@ namespace boost { namespace serialization
         }
         else
             saveSizeValue(ar, serializable_types);
+        const bool records = version >= 3 && std::is_same<Archive, boost::archive::binary_oarchive>::value;
+        std::vector<uint8_t> record;
         for(envire::core::Frame::ItemMap::const_iterator it = item_map.begin(); it != item_map.end(); it++)
         {
             if(serializable[std::distance(item_map.begin(), it)])
@@ -194,6 +479,28 @@ namespace boost { namespace serialization
                 }
                 else
                     saveSizeValue(ar, list_size);
+                if(version >= 2)
+                {
+                    // all items of a list share the same class
+                    envire::core::Serialization::HandlePtr handle;
+                    if(!envire::core::Serialization::saveClassReference(ar, item_list.front(), handle))
+                        throw std::runtime_error("Failed to reference the class of an item of type " +
+                                                 std::string(item_list.front()->getEmbeddedTypeInfo()->name()));
+                    if(records)
+                    {
+                        record.clear();
+                        if(!envire::core::Serialization::saveItemsToBinary(record, handle, item_list))
+                            throw std::runtime_error("Failed to serialize the items of type " +
+                                                     std::string(item_list.front()->getEmbeddedTypeInfo()->name()));
+                        uint64_t record_size = record.size();
+                        saveSizeValue(ar, record_size);
+                        ar.save_binary(record.data(), record.size());
+                        continue;
+                    }
+                    for(const envire::core::ItemBase::Ptr& item : item_list)
+                        handle->save(ar, item);
+                    continue;
+                }
                 for(envire::core::Frame::ItemList::const_iterator it = item_list.begin(); it != item_list.end(); it++)
                 {
                     // Serialize item
@@ -231,6 +538,10 @@ namespace boost { namespace serialization
         }
         else
             loadSizeValue(ar, map_size);
+        const bool records = version >= 3 && std::is_same<Archive, boost::archive::binary_iarchive>::value;
+        envire::core::ItemLoadFilter& filter = ar.template get_helper<envire::core::ItemLoadFilter>(envire::core::ItemLoadFilter::helperId());
+        // lists that have been skipped or deferred intentionally
+        uint64_t skipped = 0;
         for(std::size_t i = 0; i < map_size; i++)
         {
             // Recover list size
@@ -244,7 +555,66 @@ namespace boost { namespace serialization
             }
             else
                 loadSizeValue(ar, list_size);
-            if(list_size > 0)
+            if(list_size > 0 && version >= 2)
+            {
+                envire::core::ClassNameDictionary::Entry& entry = envire::core::Serialization::readClassReference(ar);
+                const envire::core::ItemLoadFilter::Action action = filter.getAction(entry.class_name);
+                if(records)
+                {
+                    uint64_t record_size;
+                    loadSizeValue(ar, record_size);
+                    if(action == envire::core::ItemLoadFilter::SKIP)
+                    {
+                        // the items are not constructed
+                        filter.skip(ar, record_size);
+                        skipped++;
+                        continue;
+                    }
+                    if(action == envire::core::ItemLoadFilter::DEFER)
+                    {
+                        // the class is resolved when the record is loaded. Thus no
+                        // plugin library is loaded for frames that are dropped.
+                        envire::core::ItemLoadFilter::Record record;
+                        record.class_name = entry.class_name;
+                        record.count = list_size;
+                        envire::core::ItemLoadFilter::read(ar, record_size, record.data);
+                        filter.deferred.push_back(std::move(record));
+                        skipped++;
+                        continue;
+                    }
+                    const envire::core::Serialization::HandlePtr& handle = envire::core::Serialization::resolveClassReference(entry);
+                    if(!handle)
+                    {
+                        LOG(ERROR) << "No serialization handle available for items of type " << entry.class_name
+                                   << ". The items have been dropped.";
+                        filter.skip(ar, record_size);
+                        skipped++;
+                        continue;
+                    }
+                    envire::core::ItemLoadFilter::read(ar, record_size, filter.buffer);
+                    if(!envire::core::Serialization::loadItemsFromBinary(filter.buffer.data(), record_size,
+                                                                         handle, list_size, item_list))
+                        LOG(ERROR) << "Failed to load items of type " << entry.class_name
+                                   << " of frame " << filter.getFrame();
+                }
+                else
+                {
+                    const envire::core::Serialization::HandlePtr& handle = envire::core::Serialization::resolveClassReference(entry);
+                    if(!handle)
+                        throw std::runtime_error("No serialization handle available for items in the archive");
+                    item_list.reserve(list_size);
+                    for(std::size_t j = 0; j < list_size; j++)
+                    {
+                        envire::core::ItemBase::Ptr item;
+                        if(handle->load(ar, item))
+                            item_list.push_back(item);
+                    }
+                    // inline items cannot be skipped, the filter is applied after loading
+                    if(!filter.applyToLoaded(action, item_list))
+                        skipped++;
+                }
+            }
+            else if(list_size > 0)
             {
                 item_list.reserve(list_size);
                 for(std::size_t j = 0; j < list_size; j++)
@@ -254,6 +624,14 @@ namespace boost { namespace serialization
                     if(envire::core::Serialization::load(ar, item))
                         item_list.push_back(item);
                 }
+                // the class name is stored per item, the filter is applied after loading
+                if(!item_list.empty())
+                {
+                    std::string class_name;
+                    item_list.front()->getClassName(class_name);
+                    if(!filter.applyToLoaded(filter.getAction(class_name), item_list))
+                        skipped++;
+                }
             }
 
             if(!item_list.empty())
@@ -264,8 +642,8 @@ namespace boost { namespace serialization
             }
         }
 
-        if(item_map.size() < map_size)
-            LOG(ERROR) << "Failed to deserialize all items. All items of " << (map_size-item_map.size()) << " types have been dropped.";
+        if(item_map.size() + skipped < map_size)
+            LOG(ERROR) << "Failed to deserialize all items. All items of " << (map_size-item_map.size()-skipped) << " types have been dropped.";
     }
 
     /**Splits serialization of envire::core::Frame::ItemMap
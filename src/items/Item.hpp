@@ -29,11 +29,16 @@
 #include "ItemBase.hpp"
 #include "ItemMetadata.hpp"
 #include "SpatioTemporal.hpp"
+#include "UUIDGenerator.hpp"
+#include "ItemPool.hpp"
 
 #include <utility>
+#include <boost/make_shared.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp>
 #include <boost_serialization/BoostTypes.hpp>
+#include <envire_core/serialization/RawSerialization.hpp>
 
 namespace envire { namespace core
 {
@@ -58,13 +63,13 @@ namespace envire { namespace core
         Item() : ItemBase()
         {
             spatio_temporal_data.time = base::Time::now();
-            spatio_temporal_data.uuid = SpatioTemporal<_ItemData>::generateNewUUID();
+            spatio_temporal_data.uuid = UUIDGenerator::generate();
         }
 
         Item(const _ItemData& data) : ItemBase(), spatio_temporal_data(data)
         {
             spatio_temporal_data.time = base::Time::now();
-            spatio_temporal_data.uuid = SpatioTemporal<_ItemData>::generateNewUUID();
+            spatio_temporal_data.uuid = UUIDGenerator::generate();
         }
 
         Item(const Item<_ItemData>& item) : ItemBase(item)
@@ -85,6 +90,50 @@ namespace envire { namespace core
 
         virtual ~Item() {}
 
+        /**Creates a new item using pooled memory for the item and the
+         * shared_ptr control block. This is the preferred way to create
+         * items at high rates.
+         * @param args are forwarded to the constructor */
+        template <typename... Args>
+        static Ptr create(Args&&... args)
+        {
+            return boost::allocate_shared<Item<_ItemData>>(ItemPoolAllocator<Item<_ItemData>>(),
+                                                           std::forward<Args>(args)...);
+        }
+
+        /**Items that are created using new (e.g. by boost serialization
+         * while loading) are allocated from the ItemPool as well.
+         * Derived classes of a different size and over-aligned items use
+         * the heap. */
+        static void* operator new(std::size_t size)
+        {
+            if(size == sizeof(Item<_ItemData>) && isPoolable<Item<_ItemData>>())
+                return ItemPool<sizeof(Item<_ItemData>)>::allocate();
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* p, std::size_t size)
+        {
+            if(size == sizeof(Item<_ItemData>) && isPoolable<Item<_ItemData>>())
+                ItemPool<sizeof(Item<_ItemData>)>::deallocate(p);
+            else
+                ::operator delete(p);
+        }
+
+#ifdef __cpp_aligned_new
+        /**Over-aligned items are allocated using the aligned global operators,
+         * which would be hidden by the class specific ones otherwise */
+        static void* operator new(std::size_t size, std::align_val_t alignment)
+        {
+            return ::operator new(size, alignment);
+        }
+
+        static void operator delete(void* p, std::size_t size, std::align_val_t alignment)
+        {
+            ::operator delete(p, size, alignment);
+        }
+#endif
+
         Item<_ItemData>& operator=(const Item<_ItemData>& item)
         {
             ItemBase::operator=(item);
@@ -169,9 +218,10 @@ namespace envire { namespace core
 
         virtual bool getClassName(std::string& class_name) const
         {
-            if (ItemMetadataMapping::containsMetadata(*getTypeInfo()))
+            const ItemMetadata* metadata = ItemMetadataMapping::findMetadata(*getTypeInfo());
+            if (metadata != NULL)
             {
-                class_name = ItemMetadataMapping::getMetadata(*getTypeInfo()).className;
+                class_name = metadata->className;
                 return true;
             }
             return false;
@@ -179,9 +229,10 @@ namespace envire { namespace core
 
         bool getEmbeddedTypeName(std::string& embedded_type_name) const
         {
-            if (ItemMetadataMapping::containsMetadata(*getTypeInfo()))
+            const ItemMetadata* metadata = ItemMetadataMapping::findMetadata(*getTypeInfo());
+            if (metadata != NULL)
             {
-                embedded_type_name = ItemMetadataMapping::getMetadata(*getTypeInfo()).embeddedTypename;
+                embedded_type_name = metadata->embeddedTypename;
                 return true;
             }
             return false;
@@ -211,9 +262,23 @@ namespace envire { namespace core
             ar & boost::serialization::make_nvp("time", spatio_temporal_data.time.microseconds);
             ar & boost::serialization::make_nvp("uuid", spatio_temporal_data.uuid);
             ar & boost::serialization::make_nvp("frame_name", spatio_temporal_data.frame_id);
-            ar & boost::serialization::make_nvp("user_data", spatio_temporal_data.data);
+            //version 1 stores trivially serializable data as raw block in binary archives
+            serializeData(ar, "user_data", spatio_temporal_data.data, version >= 1);
         }
 
     };
 
 }}
+
+namespace boost { namespace serialization
+{
+    /**Version 1 stores trivially serializable item data as raw block in
+     * binary archives, see envire::core::RawSerialization */
+    template <class _ItemData>
+    struct version<envire::core::Item<_ItemData>>
+    {
+        typedef mpl::int_<1> type;
+        typedef mpl::integral_c_tag tag;
+        BOOST_STATIC_CONSTANT(int, value = version::type::value);
+    };
+}}
@@ -26,19 +26,21 @@
 
 #include "ItemBase.hpp"
 #include "RandomGenerator.hpp"
+
+#include <algorithm>
 #define BOOST_SERIALIZATION_DYN_LINK 1
 
 using namespace envire::core;
 
-ItemBase::ItemBase()
+ItemBase::ItemBase() : contentsObserver(NULL)
 {
 }
 
-ItemBase::ItemBase(const ItemBase& item)
+ItemBase::ItemBase(const ItemBase& item) : contentsObserver(NULL)
 {
 }
 
-ItemBase::ItemBase(ItemBase&& item)
+ItemBase::ItemBase(ItemBase&& item) : contentsObserver(NULL)
 {
 }
 
@@ -61,7 +63,104 @@ std::string ItemBase::getClassName() const
 }
 
 void ItemBase::contentsChanged(){
-    itemContentsChanged(*this);
+    if(!listeners)
+    {
+        if(contentsObserver != NULL)
+            contentsObserver->itemContentsChanged(*this);
+        return;
+    }
+    //callbacks and observers may connect or disconnect callbacks and
+    //observers (including themselves) while they are notified. Until the
+    //outermost call is done nothing is erased and new callbacks are kept
+    //aside, see connectContentsChangedCallback() and removeContentsObserver().
+    ++listeners->dispatching;
+    for(std::size_t i = 0; i < listeners->callbacks.size(); ++i)
+    {
+        if(listeners->callbacks[i].connected)
+            listeners->callbacks[i].callback(*this);
+    }
+    if(contentsObserver != NULL)
+        contentsObserver->itemContentsChanged(*this);
+    //observers that are added meanwhile are appended and notified as well
+    for(std::size_t i = 0; i < listeners->observers.size(); ++i)
+    {
+        if(listeners->observers[i] != NULL)
+            listeners->observers[i]->itemContentsChanged(*this);
+    }
+    if(--listeners->dispatching == 0)
+    {
+        std::vector<ConnectedCallback>& callbacks = listeners->callbacks;
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+                                       [](const ConnectedCallback& c) { return !c.connected; }),
+                        callbacks.end());
+        callbacks.insert(callbacks.end(), listeners->connecting.begin(), listeners->connecting.end());
+        listeners->connecting.clear();
+        std::vector<ItemContentsObserver*>& observers = listeners->observers;
+        observers.erase(std::remove(observers.begin(), observers.end(), nullptr),
+                        observers.end());
+    }
+}
+
+void ItemBase::addContentsObserver(ItemContentsObserver* observer)
+{
+    assert(observer != NULL);
+    if(isObservedBy(observer))
+        return;
+    if(contentsObserver == NULL)
+    {
+        contentsObserver = observer;
+        return;
+    }
+    if(!listeners)
+        listeners.reset(new ContentsListeners());
+    listeners->observers.push_back(observer);
+}
+
+void ItemBase::removeContentsObserver(ItemContentsObserver* observer)
+{
+    if(contentsObserver == observer)
+    {
+        contentsObserver = NULL;
+        return;
+    }
+    if(!listeners)
+        return;
+    std::vector<ItemContentsObserver*>& observers = listeners->observers;
+    std::vector<ItemContentsObserver*>::iterator it = std::find(observers.begin(), observers.end(), observer);
+    if(it == observers.end())
+        return;
+    if(listeners->dispatching > 0)
+        *it = NULL; //erased by contentsChanged()
+    else
+        observers.erase(it);
+}
+
+bool ItemBase::isObservedBy(const ItemContentsObserver* observer) const
+{
+    if(observer == NULL)
+        return false;
+    if(contentsObserver == observer)
+        return true;
+    return listeners && std::find(listeners->observers.begin(), listeners->observers.end(),
+                                  observer) != listeners->observers.end();
+}
+
+std::size_t ItemBase::getContentsChangedCallbackCount() const
+{
+    if(!listeners)
+        return 0;
+    return listeners->connecting.size() +
+           std::count_if(listeners->callbacks.begin(), listeners->callbacks.end(),
+                         [](const ConnectedCallback& c) { return c.connected; });
+}
+
+std::size_t ItemBase::getContentsObserverCount() const
+{
+    std::size_t count = contentsObserver != NULL ? 1 : 0;
+    if(listeners)
+        count += listeners->observers.size() - std::count(listeners->observers.begin(),
+                                                          listeners->observers.end(), nullptr);
+    return count;
 }
 
 BOOST_CLASS_EXPORT(envire::core::ItemBase)
@@ -32,15 +32,31 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/export.hpp>
-#include <boost/signals2.hpp>
+#include <boost/function.hpp>
 #include <base/Time.hpp>
 #include <string>
 #include <type_traits>
+#include <cassert>
 #include <typeindex>
+#include <vector>
+#include <memory>
 
 namespace envire { namespace core
 {
     using FrameId = std::string;
+    
+    class ItemBase;
+    
+    /**Interface for the owner of an item (e.g. the EnvireGraph) that wants to
+     * be notified whenever the item reports a content change. */
+    class ItemContentsObserver
+    {
+    public:
+        virtual ~ItemContentsObserver() {}
+        
+        /**Is called by ItemBase::contentsChanged() */
+        virtual void itemContentsChanged(ItemBase& item) = 0;
+    };
 
     /**@class ItemBase
     *
@@ -54,6 +70,8 @@ namespace envire { namespace core
         using PtrType = boost::shared_ptr<T>;
         
         typedef PtrType<ItemBase> Ptr;
+        
+        typedef boost::function<void (ItemBase& item)> ContentsChangedCallback;
 
         ItemBase();
         ItemBase(const ItemBase& item);
@@ -138,14 +156,39 @@ namespace envire { namespace core
         /** Returns a raw pointer to the data of an Item */
         virtual void* getRawData() { return NULL; }
         
-        /** Emits the itemContentsChanged event */
+        /** Calls all connected contents changed callbacks and notifies the
+         *  contents observers.
+         *  Callbacks and observers may connect, disconnect, add or remove
+         *  callbacks and observers (including themselves) while they are
+         *  notified. Disconnected ones are not notified anymore, newly
+         *  connected ones are notified starting with the next call.
+         *  @warning Unlike the boost::signals2 signal that was used before,
+         *           the callback and observer lists are not synchronized.
+         *           contentsChanged() and all methods that connect,
+         *           disconnect, add or remove must not be called
+         *           concurrently on the same item. */
         void contentsChanged();
         
+        /**Adds an observer that is notified by contentsChanged().
+         * An item can be observed by several graphs at once, e.g. if it is
+         * shared by a graph and its copies. Adding an observer twice has no
+         * effect. Observers are not copied when the item is copied. */
+        void addContentsObserver(ItemContentsObserver* observer);
+        
+        /**Removes @p observer. Does nothing if it is not observing this item. */
+        void removeContentsObserver(ItemContentsObserver* observer);
+        
+        /** @return true if @p observer is notified by contentsChanged() */
+        bool isObservedBy(const ItemContentsObserver* observer) const;
+        
+        /** @return the number of contents observers */
+        std::size_t getContentsObserverCount() const;
+        
         /**
          * registeres a changed callback function ponter
          * @warning to receive callbacks, the contentsChanged() method must be called manually to emit the signal
          * 
-         * @param callback the function to call on change compatible with boost signal (using lambda functions or boost::bind)
+         * @param callback the function to call on change (lambda functions, functors or boost::bind)
          * The signature of the callback function is (const ItemBase& item)
          * e.g.  connectContentsChangedCallback([&reactor](const ItemBase& item){reactor.frame=item.getFrame();reactor.called=true;});
          * connectContentsChangedCallback(boost::bind(&ItemContentReactor::cb, &reactor,  _1));
@@ -153,17 +196,46 @@ namespace envire { namespace core
          * 
          */
         template<class CALLBACK> void connectContentsChangedCallback(const CALLBACK &callback){
-            itemContentsChanged.connect(callback);
+            if(!listeners)
+                listeners.reset(new ContentsListeners());
+            //the callback list must not grow while a callback is running
+            if(listeners->dispatching > 0)
+                listeners->connecting.push_back(callback);
+            else
+                listeners->callbacks.emplace_back(callback);
         }
         
         /**
-         * disconnects a connected callback
+         * disconnects all connected callbacks that are equal to @p callback
          * 
-         * @param callback the function to call on change compatible with boost signale (using functor objects or boost::bind)
+         * @param callback the function to call on change (functor objects or boost::bind)
+         * @note The callback has to be comparable using boost::function_equal
          */
         template<class CALLBACK> void disconnectContentsChangedCallback(const CALLBACK &callback){
-            itemContentsChanged.disconnect(callback);
+            if(!listeners)
+                return;
+            std::vector<ConnectedCallback>& callbacks = listeners->callbacks;
+            for(std::size_t i = 0; i < callbacks.size();)
+            {
+                if(!(callbacks[i].callback == callback))
+                    ++i;
+                else if(listeners->dispatching > 0)
+                    callbacks[i++].connected = false; //erased by contentsChanged()
+                else
+                    callbacks.erase(callbacks.begin() + i);
+            }
+            std::vector<ContentsChangedCallback>& connecting = listeners->connecting;
+            for(std::size_t i = 0; i < connecting.size();)
+            {
+                if(connecting[i] == callback)
+                    connecting.erase(connecting.begin() + i);
+                else
+                    ++i;
+            }
         }
+        
+        /** @return the number of connected contents changed callbacks */
+        std::size_t getContentsChangedCallbackCount() const;
 
     private:
         /**Grands access to boost serialization */
@@ -175,21 +247,60 @@ namespace envire { namespace core
         {
         }
         
-        /** This signal can be manually emitted to notify about the change */
-        boost::signals2::signal<void (ItemBase& item)> itemContentsChanged;
+        struct ConnectedCallback
+        {
+            ConnectedCallback(const ContentsChangedCallback& callback) :
+                callback(callback), connected(true) {}
+            ContentsChangedCallback callback;
+            /** false if disconnected during contentsChanged() */
+            bool connected;
+        };
+        
+        /** Everything that is notified by contentsChanged() apart from the
+         *  first observer. */
+        struct ContentsListeners
+        {
+            std::vector<ConnectedCallback> callbacks;
+            /** Callbacks that have been connected during contentsChanged() */
+            std::vector<ContentsChangedCallback> connecting;
+            /** Observers that have been added while contentsObserver was set */
+            std::vector<ItemContentsObserver*> observers;
+            /** Number of running contentsChanged() calls. Callbacks that are
+             *  disconnected and observers that are removed meanwhile are
+             *  only marked and erased afterwards. */
+            unsigned dispatching = 0;
+        };
+        
+        /** The listeners are only allocated once the first callback or the
+         *  second observer is added to keep items without them small.
+         *  They are not copied when the item is copied. */
+        std::unique_ptr<ContentsListeners> listeners;
+        
+        /** The first owner of this item that is interested in content
+         *  changes. Most items are observed by at most one graph. */
+        ItemContentsObserver* contentsObserver;
         
     };
 
     /**Mark this class as abstract class */
     BOOST_SERIALIZATION_ASSUME_ABSTRACT(envire::core::ItemBase);
     
+    /** Casts the items of a typed item list to their concrete type.
+     *  The item lists of a frame are keyed by the type_index of their items,
+     *  therefore the type is already known and an unchecked static downcast
+     *  is sufficient. The pointer is taken by reference to avoid touching
+     *  the reference count of the shared_ptr.
+     *  In debug builds the cast is verified using rtti. */
     template <class TARGET>
     struct ItemBaseCaster 
     {
-        TARGET& operator()(const ItemBase::Ptr p) const
+        static_assert(std::is_base_of<ItemBase, TARGET>::value,
+                      "TARGET should derive from ItemBase");
+        
+        TARGET& operator()(const ItemBase::Ptr& p) const
         {
-            //FIXME static_assert that TARGET is ItemBase::PtrType<X>
-            return *(boost::dynamic_pointer_cast<TARGET>(p));
+            assert(dynamic_cast<TARGET*>(p.get()) != nullptr);
+            return *static_cast<TARGET*>(p.get());
         }
     };
 }}
@@ -27,12 +27,13 @@
 #include "ItemMetadata.hpp"
 #include <glog/logging.h>
 #include <iostream>
+#include <stdexcept>
 using namespace std;
 
 namespace envire { namespace core
 {
 
-ItemMetadataMapping::TypeMap ItemMetadataMapping::mapping;
+atomic<const ItemMetadataMapping::Node*> ItemMetadataMapping::buckets[ItemMetadataMapping::bucketCount];
 mutex ItemMetadataMapping::mappingMutex;
 
 void ItemMetadataMapping::addMapping(const std::type_info& id, const ItemMetadata& data)
@@ -40,24 +41,42 @@ void ItemMetadataMapping::addMapping(const std::type_info& id, const ItemMetadat
   DLOG(INFO) << "Adding meta-data for " << id.name() << ". Content: className=" << data.className
             <<  ", embeddedTypename=" << data.embeddedTypename;
   
+  const type_index type(id);
+  atomic<const Node*>& bucket = buckets[type.hash_code() % bucketCount];
+  
   lock_guard<mutex> guard(mappingMutex);
-  mapping[type_index(id)] = data;
+  //the new node shadows older nodes of the same type. The old nodes are
+  //kept because readers might still be traversing them.
+  const Node* node = new Node(type, data, bucket.load(memory_order_relaxed));
+  bucket.store(node, memory_order_release);
+}
+
+const ItemMetadata* ItemMetadataMapping::findMetadata(const std::type_info& type)
+{
+  const type_index id(type);
+  const Node* node = buckets[id.hash_code() % bucketCount].load(memory_order_acquire);
+  for(; node != NULL; node = node->next)
+  {
+    if(node->type == id)
+      return &node->data;
+  }
+  return NULL;
 }
 
 const ItemMetadata& ItemMetadataMapping::getMetadata(const std::type_info& type) 
 {  
-  lock_guard<mutex> guard(mappingMutex);
-  const type_index id(type);
-  if(mapping.find(id) == mapping.end())
+  const ItemMetadata* data = findMetadata(type);
+  if(data == NULL)
+  {
     LOG(ERROR) << "No mapping for type: " << type.name();
-  return mapping.at(id);
+    throw out_of_range(string("No mapping for type: ") + type.name());
+  }
+  return *data;
 }
 
 bool ItemMetadataMapping::containsMetadata(const std::type_info& type)
 {
-  lock_guard<mutex> guard(mappingMutex);
-  const type_index id(type);
-  return mapping.find(id) != mapping.end();
+  return findMetadata(type) != NULL;
 }
 
 }}
@@ -28,8 +28,8 @@
 #include <typeindex>
 #include <typeinfo>
 #include <string>
-#include <unordered_map>
 #include <mutex>
+#include <atomic>
 /** Provides meta information such as type names of items */
 
 namespace envire { namespace core
@@ -46,27 +46,54 @@ struct ItemMetadata
     std::string embeddedTypename;
 };
 
-/**Provides a mapping between std::type_info and the metadata of the item.*/
+/**Provides a mapping between std::type_info and the metadata of the item.
+ * 
+ * The mapping is read-mostly: Metadata is only added at static
+ * initialization or when a plugin library is loaded, while it is looked up
+ * whenever the class name of an item is needed. Thus reading is lock-free,
+ * only adding metadata is synchronized.
+ * The mapping is a fixed size hash table of singly linked lists of
+ * immutable nodes. New nodes are published by atomically replacing the head
+ * of a bucket. Nodes are never removed. */
 class ItemMetadataMapping 
 {
 public:
-   
     /**Return the meta-data corresponding to @p type.
      * The returned reference has static storage duration.
-     * This method is thread-safe.
+     * This method is thread-safe and lock-free.
      * @throw std::out_of_range if type is not part of the mapping */
     static const ItemMetadata& getMetadata(const std::type_info& type);
     
-    /** Returns true if metadata for the given type is known */
+    /** Returns true if metadata for the given type is known.
+     *  This method is thread-safe and lock-free. */
     static bool containsMetadata(const std::type_info& type);
-
+    
+    /** Returns the meta-data corresponding to @p type or NULL if the type is
+     *  not part of the mapping. The returned pointer has static storage
+     *  duration. This method is thread-safe and lock-free. */
+    static const ItemMetadata* findMetadata(const std::type_info& type);
+    
 private:
     /**Add meta data for a new type.
+     * Replaces existing meta data of the type.
      * Is thread-safe.*/
     static void addMapping(const std::type_info& id, const ItemMetadata& data);
-
-    using TypeMap = std::unordered_map<std::type_index, ItemMetadata>;
-    static TypeMap mapping;
+    
+    struct Node
+    {
+        Node(const std::type_index& type, const ItemMetadata& data, const Node* next) :
+            type(type), data(data), next(next) {}
+        const std::type_index type;
+        const ItemMetadata data;
+        const Node* const next;
+    };
+    
+    static const std::size_t bucketCount = 256;
+    /**Zero initialized before any dynamic initialization takes place, i.e.
+     * it is safe to add metadata from static initializers of other
+     * translation units. */
+    static std::atomic<const Node*> buckets[bucketCount];
+    /**Serializes the writers */
     static std::mutex mappingMutex; 
     
     friend class MetadataInitializer;//needs access to addMapping()
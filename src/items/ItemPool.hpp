@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace envire { namespace core
+{
+    /**A thread local cache of freed memory blocks of size @p BlockSize.
+     *
+     * Freed blocks are kept in a per thread free list and are reused by the
+     * next allocation of the same size in the same thread. This avoids
+     * malloc calls and the corresponding contention if items are created and
+     * destroyed at high rates. Blocks may be freed by a different thread
+     * than the one that allocated them. At most maxCachedBlocks blocks are
+     * cached per thread, additional blocks are returned to the heap.
+     * The pools are shared by all types of the same size.
+     * Blocks are aligned like ::operator new, i.e. to
+     * alignof(std::max_align_t). Use isPoolable() to check a type. */
+    template <std::size_t BlockSize>
+    class ItemPool
+    {
+        static_assert(BlockSize >= sizeof(void*), "BlockSize is too small to hold a free list entry");
+
+        /**Lifetime of the FreeList of the calling thread */
+        enum FreeListState
+        {
+            FREE_LIST_UNUSED = 0,
+            FREE_LIST_ALIVE,
+            FREE_LIST_DESTROYED
+        };
+
+        /**The state is trivially destructible and thus can be read even
+         * after the FreeList of the thread has been destroyed */
+        static FreeListState& getFreeListState()
+        {
+            static thread_local FreeListState state = FREE_LIST_UNUSED;
+            return state;
+        }
+
+        struct FreeList
+        {
+            void* head;
+            std::size_t size;
+
+            FreeList() : head(nullptr), size(0)
+            {
+                getFreeListState() = FREE_LIST_ALIVE;
+            }
+            ~FreeList()
+            {
+                getFreeListState() = FREE_LIST_DESTROYED;
+                while(head != nullptr)
+                {
+                    void* next = *static_cast<void**>(head);
+                    ::operator delete(head);
+                    head = next;
+                }
+                size = 0;
+            }
+        };
+
+        static FreeList& getFreeList()
+        {
+            static thread_local FreeList freeList;
+            return freeList;
+        }
+
+    public:
+        /**Maximum number of freed blocks that are cached per thread */
+        static const std::size_t maxCachedBlocks = 4096;
+
+        /** @return a block of BlockSize bytes
+         *  @throw std::bad_alloc if the allocation failed */
+        static void* allocate()
+        {
+            //the free list is already destroyed if the thread is shutting down
+            if(getFreeListState() == FREE_LIST_DESTROYED)
+                return ::operator new(BlockSize);
+            FreeList& freeList = getFreeList();
+            if(freeList.head != nullptr)
+            {
+                void* block = freeList.head;
+                freeList.head = *static_cast<void**>(block);
+                --freeList.size;
+                return block;
+            }
+            return ::operator new(BlockSize);
+        }
+
+        /**Returns @p block to the cache of the calling thread.
+         * @param block Has to be allocated by ItemPool<BlockSize>::allocate() */
+        static void deallocate(void* block)
+        {
+            //the free list is already destroyed if the thread is shutting down
+            if(getFreeListState() == FREE_LIST_DESTROYED)
+            {
+                ::operator delete(block);
+                return;
+            }
+            FreeList& freeList = getFreeList();
+            if(freeList.size < maxCachedBlocks)
+            {
+                *static_cast<void**>(block) = freeList.head;
+                freeList.head = block;
+                ++freeList.size;
+            }
+            else
+            {
+                ::operator delete(block);
+            }
+        }
+    };
+
+    /** @return true if objects of type @p T can be drawn from the ItemPool.
+     *  Over-aligned types need more alignment than the pooled blocks provide. */
+    template <class T>
+    constexpr bool isPoolable()
+    {
+        return alignof(T) <= alignof(std::max_align_t);
+    }
+
+    /**Standard conforming allocator that draws single objects from the
+     * ItemPool of matching size. Used together with boost::allocate_shared
+     * to place the item and the shared_ptr control block in one pooled block.
+     * Arrays and over-aligned types use the default allocator. */
+    template <class T>
+    class ItemPoolAllocator
+    {
+    public:
+        typedef T value_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef ItemPoolAllocator<U> other;
+        };
+
+        ItemPoolAllocator() {}
+
+        template <class U>
+        ItemPoolAllocator(const ItemPoolAllocator<U>&) {}
+
+        T* allocate(std::size_t n)
+        {
+            if(n == 1 && isPoolable<T>())
+                return static_cast<T*>(ItemPool<sizeof(T)>::allocate());
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n)
+        {
+            if(n == 1 && isPoolable<T>())
+                ItemPool<sizeof(T)>::deallocate(p);
+            else
+                std::allocator<T>().deallocate(p, n);
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const ItemPoolAllocator<T>&, const ItemPoolAllocator<U>&) { return true; }
+
+    template <class T, class U>
+    bool operator!=(const ItemPoolAllocator<T>&, const ItemPoolAllocator<U>&) { return false; }
+}}
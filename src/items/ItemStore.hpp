@@ -0,0 +1,275 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/items/Item.hpp>
+#include <envire_core/items/UUIDGenerator.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <vector>
+#include <typeindex>
+
+namespace envire { namespace core
+{
+    /**Type independent interface of all ItemStores. */
+    class ItemStoreBase
+    {
+    public:
+        typedef boost::shared_ptr<ItemStoreBase> Ptr;
+
+        virtual ~ItemStoreBase() {}
+
+        /** @return the number of items in the store */
+        virtual std::size_t size() const = 0;
+
+        virtual bool empty() const { return size() == 0; }
+
+        /** Removes all items from the store */
+        virtual void clear() = 0;
+
+        /** @return the type_index of the item type that is stored,
+         *          i.e. typeid(Item<T>) for an ItemStore<T> */
+        virtual std::type_index getTypeIndex() const = 0;
+
+        /** Creates a heap allocated item that contains a copy of the
+         *  @p i'th entry of the store.
+         *  @throw std::out_of_range if @p i is out of range */
+        virtual ItemBase::Ptr materialize(std::size_t i, const FrameId& frame) const = 0;
+
+        /** @return a deep copy of this store */
+        virtual Ptr clone() const = 0;
+    };
+
+    /**Contiguous storage for a large number of small items of the same type.
+     *
+     * An ItemStore keeps the payloads of type @p T in a single array next to a
+     * compact header (timestamp and uuid). In contrast to Item<T> there is no
+     * per-item heap allocation, no vtable, no contentsChanged callbacks and no
+     * frame name. The frame is implicitly given by the Frame that owns the store.
+     *
+     * For code that expects an ItemBase::Ptr, an Item<T> copy of an entry can
+     * be created using materialize(). The materialized item is a copy, i.e.
+     * changes to it are not reflected in the store. Store entries are
+     * identified by their uuid.
+     *
+     * @param T the embedded data type, i.e. the T of Item<T>. */
+    template <class T>
+    class ItemStore : public ItemStoreBase
+    {
+    public:
+        typedef boost::shared_ptr<ItemStore<T>> Ptr;
+        typedef Item<T> ItemType;
+
+        /** A single element of the store */
+        struct Entry
+        {
+            base::Time time;
+            boost::uuids::uuid uuid;
+            T data;
+
+            Entry(const base::Time& time, const boost::uuids::uuid& uuid, const T& data) :
+                time(time), uuid(uuid), data(data) {}
+            Entry(const base::Time& time, const boost::uuids::uuid& uuid, T&& data) :
+                time(time), uuid(uuid), data(std::move(data)) {}
+        };
+
+        using EntryList = std::vector<Entry>;
+        using iterator = typename EntryList::iterator;
+        using const_iterator = typename EntryList::const_iterator;
+
+        iterator begin() { return entries.begin(); }
+        iterator end() { return entries.end(); }
+        const_iterator begin() const { return entries.begin(); }
+        const_iterator end() const { return entries.end(); }
+        const_iterator cbegin() const { return entries.cbegin(); }
+        const_iterator cend() const { return entries.cend(); }
+
+        Entry* data() { return entries.data(); }
+        const Entry* data() const { return entries.data(); }
+
+        Entry& operator[](std::size_t i) { return entries[i]; }
+        const Entry& operator[](std::size_t i) const { return entries[i]; }
+
+        /** @throw std::out_of_range if @p i is out of range */
+        Entry& at(std::size_t i) { return entries.at(i); }
+        const Entry& at(std::size_t i) const { return entries.at(i); }
+
+        virtual std::size_t size() const { return entries.size(); }
+
+        virtual void clear() { entries.clear(); }
+
+        void reserve(std::size_t n) { entries.reserve(n); }
+
+        virtual std::type_index getTypeIndex() const { return std::type_index(typeid(ItemType)); }
+
+        /** Appends @p data with a newly generated uuid.
+         *  @return the new entry */
+        Entry& push_back(const T& data, const base::Time& time = base::Time::now())
+        {
+            entries.emplace_back(time, UUIDGenerator::generate(), data);
+            return entries.back();
+        }
+
+        Entry& push_back(T&& data, const base::Time& time = base::Time::now())
+        {
+            entries.emplace_back(time, UUIDGenerator::generate(), std::move(data));
+            return entries.back();
+        }
+
+        /** Appends a copy of the time, uuid and data of @p item.
+         *  @return the new entry */
+        Entry& push_back(const ItemType& item)
+        {
+            entries.emplace_back(item.getTime(), item.getID(), item.getData());
+            return entries.back();
+        }
+
+        /** Removes the entry at @p it.
+         *  @return an iterator to the entry after the removed one */
+        iterator erase(const_iterator it)
+        {
+            //HACK see EnvireGraph::removeItemFromFrame, gcc bug 57158
+            return entries.erase(entries.begin() + (it - entries.cbegin()));
+        }
+
+        /** Creates a heap allocated Item<T> that contains a copy of the
+         *  @p i'th entry.
+         *  @throw std::out_of_range if @p i is out of range */
+        typename ItemType::Ptr materializeItem(std::size_t i, const FrameId& frame) const
+        {
+            return materializeEntry(entries.at(i), frame);
+        }
+
+        /** Creates a heap allocated Item<T> that contains a copy of @p entry */
+        static typename ItemType::Ptr materializeEntry(const Entry& entry, const FrameId& frame)
+        {
+            typename ItemType::Ptr item = boost::make_shared<ItemType>(entry.data);
+            item->setTime(entry.time);
+            item->setID(entry.uuid);
+            item->setFrame(frame);
+            return item;
+        }
+
+        virtual ItemBase::Ptr materialize(std::size_t i, const FrameId& frame) const
+        {
+            return materializeItem(i, frame);
+        }
+
+        virtual ItemStoreBase::Ptr clone() const
+        {
+            return boost::make_shared<ItemStore<T>>(*this);
+        }
+
+    private:
+        EntryList entries;
+    };
+
+    /**Refers to an item of type Item<T> that is either a regular item or an
+     * entry of an ItemStore<T>. Is returned by ItemDataIterator.
+     * The data is accessed in place, i.e. writes through getData() change
+     * the item or the store entry. */
+    template <class T>
+    class ItemDataRef
+    {
+    public:
+        typedef typename ItemStore<T>::Entry Entry;
+
+        ItemDataRef(const ItemBase::Ptr* item, Entry* entry, const FrameId* frame) :
+            item(item), entry(entry), frame(frame) {}
+
+        T& getData() const { return entry ? entry->data : static_cast<Item<T>&>(**item).getData(); }
+        const base::Time& getTime() const { return entry ? entry->time : (*item)->getTime(); }
+        const boost::uuids::uuid& getID() const { return entry ? entry->uuid : (*item)->getID(); }
+
+        /** @return true if this refers to an entry of the item store */
+        bool isStoreEntry() const { return entry != nullptr; }
+
+        /** @return the regular item, or a heap allocated copy of the store
+         *          entry. Changes to the copy are not reflected in the store. */
+        typename Item<T>::Ptr getItem() const
+        {
+            if(entry)
+                return ItemStore<T>::materializeEntry(*entry, *frame);
+            return boost::static_pointer_cast<Item<T>>(*item);
+        }
+
+    private:
+        const ItemBase::Ptr* item;
+        Entry* entry;
+        const FrameId* frame;
+    };
+
+    /**Forward iterator over the regular items of type Item<T> of a frame,
+     * followed by the entries of the ItemStore<T> of that frame.
+     * Dereferencing yields an ItemDataRef<T>, no item is copied. */
+    template <class T>
+    class ItemDataIterator : public boost::iterator_facade<ItemDataIterator<T>, ItemDataRef<T>,
+                                                           boost::forward_traversal_tag, ItemDataRef<T>>
+    {
+    public:
+        typedef typename ItemStore<T>::Entry Entry;
+
+        ItemDataIterator() : item(nullptr), itemsEnd(nullptr), entry(nullptr), frame(nullptr) {}
+
+        /**@param item the current regular item, equal to @p itemsEnd once
+         *             all regular items have been visited
+         * @param entry the current store entry */
+        ItemDataIterator(const ItemBase::Ptr* item, const ItemBase::Ptr* itemsEnd,
+                         Entry* entry, const FrameId* frame) :
+            item(item), itemsEnd(itemsEnd), entry(entry), frame(frame) {}
+
+    private:
+        friend class boost::iterator_core_access;
+
+        void increment()
+        {
+            if(item != itemsEnd)
+                ++item;
+            else
+                ++entry;
+        }
+
+        bool equal(const ItemDataIterator& other) const
+        {
+            return item == other.item && entry == other.entry;
+        }
+
+        ItemDataRef<T> dereference() const
+        {
+            if(item != itemsEnd)
+                return ItemDataRef<T>(item, nullptr, frame);
+            return ItemDataRef<T>(nullptr, entry, frame);
+        }
+
+        const ItemBase::Ptr* item;
+        const ItemBase::Ptr* itemsEnd;
+        Entry* entry;
+        const FrameId* frame;
+    };
+}}
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "UUIDGenerator.hpp"
+#include "RandomGenerator.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+using namespace envire::core;
+
+namespace
+{
+    std::atomic<UUIDGenerator::GeneratorFunction> generatorFunction(&UUIDGenerator::generateFast);
+
+    /**Per thread state of generateFast() */
+    struct FastGeneratorState
+    {
+        uint64_t prefix;
+        uint64_t counter;
+        bool initialized;
+    };
+
+    //counter values are limited to 62 bit because the two most significant
+    //bits are used for the uuid variant
+    const uint64_t counterLimit = uint64_t(1) << 62;
+
+    thread_local FastGeneratorState state = {0, 0, false};
+
+    void drawPrefix()
+    {
+        const boost::uuids::uuid random = RandomGenerator::getRandomGenerator()();
+        std::memcpy(&state.prefix, random.data, sizeof(state.prefix));
+        state.counter = 0;
+        state.initialized = true;
+    }
+}
+
+boost::uuids::uuid UUIDGenerator::generate()
+{
+    return generatorFunction.load(std::memory_order_relaxed)();
+}
+
+void UUIDGenerator::setGenerator(GeneratorFunction generator)
+{
+    if(generator == NULL)
+        generator = &UUIDGenerator::generateFast;
+    generatorFunction.store(generator, std::memory_order_relaxed);
+}
+
+boost::uuids::uuid UUIDGenerator::generateFast()
+{
+    if(!state.initialized || state.counter >= counterLimit)
+    {
+        drawPrefix();
+    }
+    const uint64_t count = state.counter++;
+
+    boost::uuids::uuid id;
+    std::memcpy(id.data, &state.prefix, sizeof(state.prefix));
+    for(int i = 0; i < 8; ++i)
+    {
+        id.data[15 - i] = static_cast<uint8_t>(count >> (8 * i));
+    }
+    //version 4 (random) and variant 10xx as defined in RFC 4122
+    id.data[6] = (id.data[6] & 0x0F) | 0x40;
+    id.data[8] = (id.data[8] & 0x3F) | 0x80;
+    return id;
+}
+
+boost::uuids::uuid UUIDGenerator::generateRandom()
+{
+    return RandomGenerator::getRandomGenerator()();
+}
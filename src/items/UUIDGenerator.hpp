@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <boost/uuid/uuid.hpp>
+
+namespace envire { namespace core
+{
+    /**Generates the uuids of newly created items.
+     *
+     * By default a fast, lock-free and thread local generator is used: Each
+     * thread draws a random 60 bit prefix once and combines it with a
+     * thread local 62 bit counter. This is not suitable for cryptographic
+     * purposes but it is unique as long as no two threads draw the same
+     * prefix. The generated uuids are valid version 4 uuids.
+     *
+     * The generator can be replaced at runtime using setGenerator(), e.g.
+     * to use generateRandom() if fully random uuids are required. */
+    class UUIDGenerator
+    {
+    public:
+        typedef boost::uuids::uuid (*GeneratorFunction)();
+
+        /** @return a new uuid created by the current generator function.
+         *  This method is thread safe. */
+        static boost::uuids::uuid generate();
+
+        /**Replaces the generator function that is used by generate().
+         * @param generator The new generator. Has to be thread safe.
+         *                  If NULL the default generator (generateFast) is used. */
+        static void setGenerator(GeneratorFunction generator);
+
+        /** @return a new uuid consisting of a per thread random prefix and
+         *          a per thread counter. Lock-free and thread safe. */
+        static boost::uuids::uuid generateFast();
+
+        /** @return a new uuid created by a thread local
+         *          boost::uuids::random_generator. Thread safe but slow. */
+        static boost::uuids::uuid generateRandom();
+    };
+}}
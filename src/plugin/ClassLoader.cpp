@@ -27,13 +27,15 @@
 #include <envire_core/plugin/ClassLoader.hpp>
 #include <glog/logging.h>
 
+#include <algorithm>
+
 using namespace envire::core;
 
 constexpr char ClassLoader::envire_item_base_class[];
 constexpr char ClassLoader::envire_item_class[];
 constexpr char ClassLoader::envire_collision_base_class[];
 
-ClassLoader::ClassLoader() : PluginLoader()
+ClassLoader::ClassLoader() : PluginLoader(), index_valid(false), all_libraries_loaded(false)
 {
 
 }
@@ -60,41 +62,170 @@ bool ClassLoader::hasCollisionObject(const std::string& class_name) const
 
 bool ClassLoader::createEnvireItem(const std::string& item_name, envire::core::ItemBase::Ptr& base_item)
 {
+    // loads only the library of the class, unknown classes are left to the plugin loader
+    loadEnvireItemLibrary(item_name);
+    if(createInstance<envire::core::ItemBase>(item_name, base_item))
+        return true;
+    // the index might be outdated, retry once if it has changed
+    bool index_changed;
+    {
+        std::lock_guard<std::recursive_mutex> guard(index_mutex);
+        index_changed = revalidateIndex();
+    }
+    if(!index_changed)
+        return false;
+    loadEnvireItemLibrary(item_name);
     return createInstance<envire::core::ItemBase>(item_name, base_item);
 }
 
 bool ClassLoader::createEnvireItemFor(const std::string& embedded_type, envire::core::ItemBase::Ptr& base_item)
 {
-    if(createEnvireItem(std::string(envire_item_class) + "<" + embedded_type + ">", base_item))
-        return true;
+    std::string class_name;
+    if(findEnvireItemClass(embedded_type, class_name))
+        return createEnvireItem(class_name, base_item);
+    return false;
+}
 
-    // try to get the envire item name using the associated classes
-    std::string associated_class;
-    if(getAssociatedClassOfType(embedded_type, envire_item_base_class, associated_class))
+bool ClassLoader::findEnvireItemClass(const std::string& embedded_type, std::string& class_name)
+{
+    std::lock_guard<std::recursive_mutex> guard(index_mutex);
+    updateIndex();
+    auto it = embedded_types.find(embedded_type);
+    if(it == embedded_types.end() && revalidateIndex())
+        it = embedded_types.find(embedded_type);
+    if(it == embedded_types.end())
     {
-        return createEnvireItem(associated_class, base_item);
+        // not declared in the plugin xml files, try the associated classes
+        std::string associated_class;
+        if(!getAssociatedClassOfType(embedded_type, envire_item_base_class, associated_class))
+            associated_class.clear();
+        it = embedded_types.insert(std::make_pair(embedded_type, associated_class)).first;
     }
-    return false;
+    class_name = it->second;
+    return !class_name.empty();
+}
+
+void ClassLoader::clear()
+{
+    std::lock_guard<std::recursive_mutex> guard(index_mutex);
+    PluginLoader::clear();
+    loaded_libraries.clear();
+    index_valid = false;
+}
+
+void ClassLoader::reloadXMLPluginFiles()
+{
+    std::lock_guard<std::recursive_mutex> guard(index_mutex);
+    PluginLoader::reloadXMLPluginFiles();
+    index_valid = false;
+}
+
+void ClassLoader::overridePluginXmlPaths(const std::vector<std::string>& plugin_xml_paths)
+{
+    std::lock_guard<std::recursive_mutex> guard(index_mutex);
+    PluginLoader::overridePluginXmlPaths(plugin_xml_paths);
+    index_valid = false;
 }
 
 bool ClassLoader::loadEnvireItemLibrary(const std::string& item_name)
 {
-    if(hasEnvireItem(item_name))
-        return loadLibrary(item_name);
+    std::lock_guard<std::recursive_mutex> guard(index_mutex);
+    updateIndex();
+    if(item_plugins.count(item_name) == 0 && !revalidateIndex())
+        return false;
+    return loadIndexedLibrary(item_name);
+}
+
+bool ClassLoader::loadEnvireItemLibraryFor(const std::string& embedded_type)
+{
+    std::string class_name;
+    if(findEnvireItemClass(embedded_type, class_name))
+        return loadEnvireItemLibrary(class_name);
     return false;
 }
 
 bool ClassLoader::loadAllEnvireItemLibraries()
 {
-    std::vector<std::string> item_classes = getAvailableClasses(envire_item_base_class);
+    std::lock_guard<std::recursive_mutex> guard(index_mutex);
+    updateIndex();
+    if(all_libraries_loaded)
+        return true;
     bool load_fails = false;
-    for (std::string item_name : item_classes)
+    for(const auto& plugin : item_plugins)
     {
-        if(!loadLibrary(item_name))
+        if(!loadIndexedLibrary(plugin.first))
         {
             load_fails = true;
-            LOG(ERROR) << "Failed to load plugin library of EnviRe item " << item_name;
+            LOG(ERROR) << "Failed to load plugin library of EnviRe item " << plugin.first;
+        }
+    }
+    all_libraries_loaded = !load_fails;
+    return !load_fails;
+}
+
+void ClassLoader::updateIndex()
+{
+    if(index_valid)
+        return;
+    item_plugins.clear();
+    embedded_types.clear();
+    failed_libraries.clear();
+    all_libraries_loaded = false;
+
+    const std::string item_prefix = std::string(envire_item_class) + "<";
+    for(const std::string& class_name : getAvailableClasses(envire_item_base_class))
+    {
+        ItemPluginInfo& info = item_plugins[class_name];
+        if(!getClassLibraryPath(class_name, info.library_path))
+            info.library_path.clear();
+        if(!getClassEmbeddedType(class_name, info.embedded_type) || info.embedded_type.empty())
+        {
+            // derive the embedded type from the naming convention of ENVIRE_REGISTER_ITEM
+            info.embedded_type.clear();
+            if(class_name.compare(0, item_prefix.size(), item_prefix) == 0 && class_name.back() == '>')
+                info.embedded_type = class_name.substr(item_prefix.size(), class_name.size() - item_prefix.size() - 1);
         }
+        if(!info.embedded_type.empty())
+            embedded_types.insert(std::make_pair(info.embedded_type, class_name));
+    }
+    index_valid = true;
+}
+
+bool ClassLoader::revalidateIndex()
+{
+    updateIndex();
+    const auto classes = getAvailableClasses(envire_item_base_class);
+    const bool unchanged = classes.size() == item_plugins.size() &&
+        std::all_of(classes.begin(), classes.end(), [this](const std::string& class_name)
+        {
+            return item_plugins.count(class_name) > 0;
+        });
+    if(unchanged)
+        return false;
+    // the plugin information has been changed without invalidating the index
+    loaded_libraries.clear();
+    index_valid = false;
+    updateIndex();
+    return true;
+}
+
+bool ClassLoader::loadIndexedLibrary(const std::string& item_name)
+{
+    auto it = item_plugins.find(item_name);
+    if(it == item_plugins.end())
+        return false;
+    const std::string& library_path = it->second.library_path;
+    if(!library_path.empty() && loaded_libraries.count(library_path) > 0)
+        return true;
+    if(!library_path.empty() && failed_libraries.count(library_path) > 0)
+        return false;
+    if(!loadLibrary(item_name))
+    {
+        if(!library_path.empty())
+            failed_libraries.insert(library_path);
+        return false;
     }
-    return load_fails;
+    if(!library_path.empty())
+        loaded_libraries.insert(library_path);
+    return true;
 }
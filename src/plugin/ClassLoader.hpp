@@ -27,6 +27,9 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
 #include <base-logging/Singleton.hpp>
@@ -43,6 +46,14 @@ class Serialization;
  * @class ClassLoader
  * @brief A singleton class used to load class loader based plugins
  * This class inherits from the PluginManager
+ *
+ * The envire item plugins are indexed on first use. The index maps the class
+ * names and the embedded type names of the items to their libraries. Thus
+ * only the library of a requested class is loaded, and only once.
+ * The index is rebuilt after the plugin xml files have been reloaded.
+ * The methods of the PluginLoader that change the plugin information are
+ * not virtual. If they are called through a PluginLoader reference the index
+ * is checked against the available classes on the next lookup miss instead.
  */
 class ClassLoader : public plugin_manager::PluginLoader
 {
@@ -99,6 +110,30 @@ public:
      */
     bool createEnvireItemFor(const std::string& embedded_type, envire::core::ItemBase::Ptr& base_item);
 
+    /**
+     * @brief Returns the class name of the envire item for the given embedded type.
+     * Results are memoized, including unknown types.
+     * @param embedded_type The class name of the embedded type
+     * @param class_name the name of the plugin class
+     * @return True if an envire item for the embedded type is available
+     */
+    bool findEnvireItemClass(const std::string& embedded_type, std::string& class_name);
+
+    /**
+     * @brief Removes all plugin information and invalidates the plugin index.
+     */
+    void clear();
+
+    /**
+     * @brief Reloads the plugin xml files and invalidates the plugin index.
+     */
+    void reloadXMLPluginFiles();
+
+    /**
+     * @brief Overrides the plugin xml paths and invalidates the plugin index.
+     */
+    void overridePluginXmlPaths(const std::vector<std::string>& plugin_xml_paths);
+
     /**
      * @brief Creates a collision object for the given class.
      *        The collision object must inherit from envire::collision::ODECollisionBase.
@@ -122,21 +157,72 @@ public:
 protected:
     /**
      * @brief This method allows to load the shared library of the given plugin class name.
+     * Only the library of the class is loaded, each library is loaded once.
      *
      * @param item_name the name of the plugin class
      * @returns true if successfully loaded or when already loaded
      */
     bool loadEnvireItemLibrary(const std::string& item_name);
 
+    /**
+     * @brief Loads the shared library of the envire item for the given embedded type.
+     *
+     * @param embedded_type The class name of the embedded type
+     * @returns true if successfully loaded or when already loaded
+     */
+    bool loadEnvireItemLibraryFor(const std::string& embedded_type);
+
     /**
      * @brief Loads all available shared libraries providing plugins
      * of the base class envire::core::ItemBase.
+     * Each library is loaded once, even if it provides several items.
      *
      * @returns true if all libraries have been loaded successfully
      */
     bool loadAllEnvireItemLibraries();
 
 private:
+    /** Index entry of an envire item plugin */
+    struct ItemPluginInfo
+    {
+        std::string library_path;
+        std::string embedded_type;
+    };
+
+    /**
+     * @brief Builds the plugin index if it is not valid.
+     * Has to be called with index_mutex locked.
+     */
+    void updateIndex();
+
+    /**
+     * @brief Rebuilds the plugin index if the envire item classes of the
+     * PluginLoader differ from the indexed ones, e.g. because the plugin
+     * information has been changed through a PluginLoader reference.
+     * Has to be called with index_mutex locked.
+     * @returns true if the index has been rebuilt
+     */
+    bool revalidateIndex();
+
+    /** Loads the library of @p item_name. Has to be called with index_mutex locked. */
+    bool loadIndexedLibrary(const std::string& item_name);
+
+    /** Class name of the envire items to their index entry */
+    std::unordered_map<std::string, ItemPluginInfo> item_plugins;
+    /** Embedded type to class name. An empty class name marks unknown types. */
+    std::unordered_map<std::string, std::string> embedded_types;
+    /** Paths of the libraries that have been loaded */
+    std::unordered_set<std::string> loaded_libraries;
+    /** Paths of the libraries that failed to load. They are not loaded
+     *  again until the index is rebuilt. */
+    std::unordered_set<std::string> failed_libraries;
+    bool index_valid;
+    bool all_libraries_loaded;
+    /** Recursive because loading a library might create items.
+     *  Loaded libraries register their serialization handles, thus the lock
+     *  order is index_mutex before Serialization::getHandleMutex(). */
+    std::recursive_mutex index_mutex;
+
     /**
      * @brief Constructor for ClassLoader
      * It is protected because this class is a singleton class.
@@ -24,10 +24,14 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
+
 #pragma once
 
 #include <vector>
 #include <streambuf>
+#include <memory>
+#include <algorithm>
+#include <cstring>
 #include <cstdint>
 
 namespace envire { namespace core
@@ -51,30 +55,194 @@ public:
 /**
  * @brief Helper class which defines a std::streambuf which writes
  * direcly in a std::vector<uint8_t>.
+ *
+ * The data is appended to the content of the vector. The vector grows
+ * geometrically and is used as put area directly, i.e. the data is not
+ * copied. Reusing a vector avoids allocations altogether.
+ *
+ * @note The vector is resized ahead of the data. Its size is only valid
+ *       after pubsync() has been called or the buffer has been destroyed.
  */
 class BinaryOutputBuffer : public std::streambuf
 {
 public:
     BinaryOutputBuffer(std::vector<uint8_t> *buffer) : buffer(buffer)
     {
-        this->setp((char*)buffer->data(), (char*)(buffer->data() + buffer->size()));
+        // use the capacity that is already available
+        const size_t end = buffer->size();
+        buffer->resize(std::max(buffer->capacity(), end));
+        setPutArea(end);
+    }
+
+    ~BinaryOutputBuffer()
+    {
+        sync();
+    }
+
+    /** @return the size of the vector including the data written so far */
+    size_t size() const
+    {
+        return this->pptr() - (char*)buffer->data();
     }
 
+protected:
     /**
      * This method is called by sputc if the current put pointer is equal to the end pointer.
      */
     int overflow(int c)
     {
-        // increase buffer size by one
-        buffer->resize(buffer->size()+1);
-        // reset offsets
-        this->setp((char*)(buffer->data() + buffer->size()-1), (char*)(buffer->data() + buffer->size()));
-        // recall sputc
-        return this->sputc(c);
+        if(traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        grow(1);
+        *this->pptr() = traits_type::to_char_type(c);
+        this->pbump(1);
+        return c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n)
+    {
+        if(this->epptr() - this->pptr() < n)
+            grow(n);
+        std::memcpy(this->pptr(), s, n);
+        setPutArea(size() + n);
+        return n;
+    }
+
+    /** Shrinks the vector to the data that has been written */
+    int sync()
+    {
+        const size_t end = size();
+        buffer->resize(end);
+        setPutArea(end);
+        return 0;
     }
 
 private:
+    /** Resizes the vector geometrically to fit at least @p n more bytes */
+    void grow(std::streamsize n)
+    {
+        static const size_t min_size = 64;
+        const size_t end = size();
+        buffer->resize(std::max(std::max(end + n, 2 * buffer->size()), min_size));
+        setPutArea(end);
+    }
+
+    void setPutArea(size_t end)
+    {
+        char* data = (char*)buffer->data();
+        this->setp(data + end, data + buffer->size());
+    }
+
     std::vector<uint8_t> *buffer;
 };
 
-}}
\ No newline at end of file
+/**
+ * @brief Helper class which defines a std::streambuf which writes into a
+ * list of fixed size chunks.
+ *
+ * In contrast to the BinaryOutputBuffer, data that has been written is never
+ * moved. The chunks can be handed to scatter-gather I/O (e.g. writev() or
+ * sendmsg()) directly. clear() keeps the chunks, thus a reused buffer does
+ * not allocate.
+ */
+class BinaryChunkedOutputBuffer : public std::streambuf
+{
+public:
+    /** A contiguous piece of the written data */
+    struct Chunk
+    {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    explicit BinaryChunkedOutputBuffer(size_t chunk_size = 4096) :
+        chunk_size(chunk_size), current(0), written(0)
+    {
+        this->setp(NULL, NULL);
+    }
+
+    /** @return the number of bytes that have been written */
+    size_t size() const
+    {
+        return written + (this->pptr() - this->pbase());
+    }
+
+    /** @return the written data, ordered */
+    std::vector<Chunk> getChunks() const
+    {
+        std::vector<Chunk> result;
+        size_t remaining = size();
+        for(size_t i = 0; remaining > 0; ++i)
+        {
+            const Chunk chunk = {chunks[i].get(), std::min(remaining, chunk_size)};
+            result.push_back(chunk);
+            remaining -= chunk.size;
+        }
+        return result;
+    }
+
+    /** Appends the written data to @p binary */
+    void copyTo(std::vector<uint8_t>& binary) const
+    {
+        binary.reserve(binary.size() + size());
+        for(const Chunk& chunk : getChunks())
+            binary.insert(binary.end(), chunk.data, chunk.data + chunk.size);
+    }
+
+    /** Discards the written data. The chunks are kept for reuse */
+    void clear()
+    {
+        current = 0;
+        written = 0;
+        this->setp(NULL, NULL);
+    }
+
+protected:
+    int overflow(int c)
+    {
+        if(traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        nextChunk();
+        *this->pptr() = traits_type::to_char_type(c);
+        this->pbump(1);
+        return c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n)
+    {
+        std::streamsize remaining = n;
+        while(remaining > 0)
+        {
+            if(this->pptr() == this->epptr())
+                nextChunk();
+            const std::streamsize count = std::min<std::streamsize>(remaining, this->epptr() - this->pptr());
+            std::memcpy(this->pptr(), s, count);
+            this->pbump(count);
+            s += count;
+            remaining -= count;
+        }
+        return n;
+    }
+
+private:
+    /** Continues in the next chunk, allocates it if necessary */
+    void nextChunk()
+    {
+        if(this->pbase() != NULL)
+        {
+            written += this->pptr() - this->pbase();
+            ++current;
+        }
+        if(current == chunks.size())
+            chunks.emplace_back(new uint8_t[chunk_size]);
+        char* data = (char*)chunks[current].get();
+        this->setp(data, data + chunk_size);
+    }
+
+    const size_t chunk_size;
+    std::vector<std::unique_ptr<uint8_t[]>> chunks;
+    size_t current; /** index of the chunk that is written */
+    size_t written; /** bytes in the chunks before the current one */
+};
+
+}}
@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/serialization/SerializationHandle.hpp>
+#include <boost/shared_ptr.hpp>
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+namespace envire { namespace core
+{
+
+/**
+ * @brief Dictionary of the item class names in an archive.
+ *
+ * Each distinct class name is written to the archive once, when it is
+ * referenced for the first time. Afterwards it is referenced by its index.
+ * The serialization handle is resolved once per entry, when it is needed
+ * for the first time.
+ *
+ * One dictionary is attached to each archive using the boost archive helper
+ * mechanism, i.e. its lifetime is the lifetime of the archive.
+ * @see Serialization::saveClassReference()
+ */
+class ClassNameDictionary
+{
+public:
+    struct Entry
+    {
+        Entry() : resolved(false) {}
+        std::string class_name;
+        boost::shared_ptr<SerializationHandle> handle;
+        /** true if the handle has been looked up, even if none was found */
+        bool resolved;
+    };
+
+    /**
+     * @brief Looks up the index of @p class_name, adds it if necessary.
+     *
+     * @return true if the class name has been added to the dictionary
+     */
+    bool insert(const std::string& class_name, uint64_t& index)
+    {
+        auto result = indices.insert(std::make_pair(class_name, entries.size()));
+        index = result.first->second;
+        if(result.second)
+        {
+            Entry entry;
+            entry.class_name = class_name;
+            entry.resolved = true;
+            entries.push_back(entry);
+        }
+        return result.second;
+    }
+
+    /** @return the number of entries */
+    uint64_t size() const { return entries.size(); }
+
+    /**
+     * @brief Key of the dictionary in the helper collection of an archive.
+     * Must be unique, boost uses the default key 0 for its own helpers.
+     */
+    static void* helperId()
+    {
+        static char id;
+        return &id;
+    }
+
+    std::vector<Entry> entries;
+
+private:
+    std::unordered_map<std::string, uint64_t> indices;
+};
+
+}}
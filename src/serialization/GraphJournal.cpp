@@ -0,0 +1,408 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "GraphJournal.hpp"
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/graph/GraphExceptions.hpp>
+#include <envire_core/serialization/GraphSnapshot.hpp>
+#include <envire_core/serialization/Serialization.hpp>
+#include <envire_core/serialization/BinaryBufferHelper.hpp>
+#include <envire_core/events/EdgeEvents.hpp>
+#include <envire_core/events/FrameEvents.hpp>
+#include <envire_core/events/ItemAddedEvent.hpp>
+#include <envire_core/events/ItemRemovedEvent.hpp>
+#include <envire_core/events/ItemModifiedEvent.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost_serialization/BoostTypes.hpp>
+#include <cstring>
+#include <limits>
+#include <cstdio>
+#include <glog/logging.h>
+
+using namespace envire::core;
+
+namespace
+{
+    const char MAGIC[8] = {'E', 'N', 'V', 'I', 'R', 'E', 'J', 'L'};
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct JournalHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+    };
+
+    /**Length prefix of a record */
+    typedef uint32_t RecordSize;
+
+    /**Type code of a record as stored in the journal.
+     * These values are part of the file format and are independent of
+     * GraphEvent::Type. Never change or reuse a value, only append new ones. */
+    enum RecordType
+    {
+        RECORD_EDGE_ADDED = 0,
+        RECORD_EDGE_REMOVED = 1,
+        RECORD_EDGE_MODIFIED = 2,
+        RECORD_ITEM_ADDED = 3,
+        RECORD_ITEM_REMOVED = 4,
+        RECORD_ITEM_MODIFIED = 5,
+        RECORD_FRAME_ADDED = 6,
+        RECORD_FRAME_REMOVED = 7
+    };
+
+    /**Serializes the record type and the data written by @p func to @p record.
+     * @return false if @p func failed */
+    template <class Func>
+    bool writeRecord(std::vector<uint8_t>& record, RecordType type, Func func)
+    {
+        record.clear();
+        BinaryOutputBuffer buffer(&record);
+        std::ostream stream(&buffer);
+        boost::archive::binary_oarchive oa(stream, boost::archive::no_header);
+        const int recordType = type;
+        oa << recordType;
+        return func(oa);
+    }
+
+    ItemBase::Ptr findItem(const EnvireGraph& graph, const FrameId& frame,
+                           const boost::uuids::uuid& id)
+    {
+        ItemBase::Ptr found;
+        graph.visitItems(frame, [&](const ItemBase::Ptr& item)
+        {
+            if(!found && item->getID() == id)
+                found = item;
+        });
+        return found;
+    }
+
+    /**Applies a single record to @p graph.
+     * @return false if the record could not be applied */
+    bool applyRecord(EnvireGraph& graph, boost::archive::binary_iarchive& ia)
+    {
+        int type;
+        ia >> type;
+        switch(type)
+        {
+            case RECORD_FRAME_ADDED:
+            case RECORD_FRAME_REMOVED:
+            {
+                FrameId frame;
+                ia >> frame;
+                if(type == RECORD_FRAME_ADDED)
+                    graph.addFrame(frame);
+                else
+                    graph.removeFrame(frame);
+                return true;
+            }
+            case RECORD_EDGE_ADDED:
+            case RECORD_EDGE_MODIFIED:
+            {
+                FrameId origin, target;
+                Transform tf;
+                ia >> origin >> target >> tf;
+                if(type == RECORD_EDGE_ADDED)
+                    graph.addTransform(origin, target, tf);
+                else
+                    graph.updateTransform(origin, target, tf);
+                return true;
+            }
+            case RECORD_EDGE_REMOVED:
+            {
+                FrameId origin, target;
+                ia >> origin >> target;
+                graph.removeTransform(origin, target);
+                return true;
+            }
+            case RECORD_ITEM_ADDED:
+            case RECORD_ITEM_MODIFIED:
+            {
+                FrameId frame;
+                ia >> frame;
+                ItemBase::Ptr item;
+                if(!Serialization::load(ia, item))
+                    return false;
+                if(type == RECORD_ITEM_MODIFIED)
+                {
+                    ItemBase::Ptr old = findItem(graph, frame, item->getID());
+                    if(old)
+                        graph.removeItemFromFrame(old);
+                }
+                graph.addItemToFrame(frame, item);
+                return true;
+            }
+            case RECORD_ITEM_REMOVED:
+            {
+                FrameId frame;
+                boost::uuids::uuid id;
+                ia >> frame >> id;
+                ItemBase::Ptr item = findItem(graph, frame, id);
+                if(!item)
+                {
+                    //the item might have been removed by a snapshot that
+                    //already contains this record. Nothing left to do.
+                    LOG(WARNING) << "Journal removes unknown item " << id
+                                 << " from frame " << frame << ", ignoring";
+                    return true;
+                }
+                graph.removeItemFromFrame(item);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+}
+
+GraphJournal::GraphJournal(EnvireGraph* graph, const std::string& segment) :
+    graph(graph), recordCount(0)
+{
+    open(segment);
+    subscribe(graph);
+}
+
+GraphJournal::~GraphJournal()
+{
+    //do not throw from the destructor
+    out.exceptions(std::ofstream::goodbit);
+    out.close();
+}
+
+void GraphJournal::rotate(const std::string& segment)
+{
+    open(segment);
+}
+
+void GraphJournal::open(const std::string& segment)
+{
+    std::ifstream existing(segment.c_str(), std::ios::binary | std::ios::ate);
+    const bool empty = !existing || existing.tellg() <= 0;
+    existing.close();
+
+    std::ofstream next;
+    next.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    next.open(segment.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+    if(empty)
+    {
+        JournalHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        next.write(reinterpret_cast<const char*>(&header), sizeof(JournalHeader));
+        next.flush();
+    }
+
+    //only replace the current segment once the new one is ready
+    out.exceptions(std::ofstream::goodbit);
+    out.close();
+    out.swap(next);
+    this->segment = segment;
+    recordCount = 0;
+}
+
+void GraphJournal::append(const std::vector<uint8_t>& record)
+{
+    //records are written in one piece and flushed immediately. A crash
+    //thus loses at most the last record.
+    if(record.size() > std::numeric_limits<RecordSize>::max())
+    {
+        LOG(ERROR) << "Journal record of " << record.size()
+                   << " bytes exceeds the maximum record size, dropping it";
+        return;
+    }
+    const RecordSize size = record.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(RecordSize));
+    out.write(reinterpret_cast<const char*>(record.data()), record.size());
+    out.flush();
+    ++recordCount;
+}
+
+void GraphJournal::frameAdded(const FrameAddedEvent& e)
+{
+    writeRecord(record, RECORD_FRAME_ADDED, [&](boost::archive::binary_oarchive& oa)
+    {
+        oa << e.frame;
+        return true;
+    });
+    append(record);
+}
+
+void GraphJournal::frameRemoved(const FrameRemovedEvent& e)
+{
+    writeRecord(record, RECORD_FRAME_REMOVED, [&](boost::archive::binary_oarchive& oa)
+    {
+        oa << e.frame;
+        return true;
+    });
+    append(record);
+}
+
+void GraphJournal::edgeAdded(const EdgeAddedEvent& e)
+{
+    writeRecord(record, RECORD_EDGE_ADDED, [&](boost::archive::binary_oarchive& oa)
+    {
+        oa << e.origin << e.target << graph->getEdgeProperty(e.edge);
+        return true;
+    });
+    append(record);
+}
+
+void GraphJournal::edgeModified(const EdgeModifiedEvent& e)
+{
+    writeRecord(record, RECORD_EDGE_MODIFIED, [&](boost::archive::binary_oarchive& oa)
+    {
+        oa << e.origin << e.target << graph->getEdgeProperty(e.edge);
+        return true;
+    });
+    append(record);
+}
+
+void GraphJournal::edgeRemoved(const EdgeRemovedEvent& e)
+{
+    writeRecord(record, RECORD_EDGE_REMOVED, [&](boost::archive::binary_oarchive& oa)
+    {
+        oa << e.origin << e.target;
+        return true;
+    });
+    append(record);
+}
+
+void GraphJournal::itemAdded(const ItemAddedEvent& e)
+{
+    if(writeRecord(record, RECORD_ITEM_ADDED, [&](boost::archive::binary_oarchive& oa)
+    {
+        oa << e.frame;
+        return Serialization::save(oa, e.item);
+    }))
+        append(record);
+}
+
+void GraphJournal::itemModified(const ItemModifiedEvent& e)
+{
+    if(writeRecord(record, RECORD_ITEM_MODIFIED, [&](boost::archive::binary_oarchive& oa)
+    {
+        oa << e.frame;
+        return Serialization::save(oa, e.item);
+    }))
+        append(record);
+}
+
+void GraphJournal::itemRemoved(const ItemRemovedEvent& e)
+{
+    //additions of such items are not recorded either
+    if(!Serialization::isSerializable(e.item))
+        return;
+    writeRecord(record, RECORD_ITEM_REMOVED, [&](boost::archive::binary_oarchive& oa)
+    {
+        oa << e.frame << e.item->getID();
+        return true;
+    });
+    append(record);
+}
+
+size_t GraphJournal::replay(EnvireGraph& graph, const std::string& segment)
+{
+    std::ifstream in(segment.c_str(), std::ios::binary);
+    if(!in)
+        throw InvalidJournalException(segment, "cannot open file");
+
+    JournalHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(JournalHeader));
+    if(in.gcount() != sizeof(JournalHeader) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw InvalidJournalException(segment, "bad magic");
+    if(header.byteOrder != BYTE_ORDER_MARK)
+        throw InvalidJournalException(segment, "byte order mismatch");
+    if(header.version != VERSION)
+        throw InvalidJournalException(segment, "unsupported version " + std::to_string(header.version));
+
+    size_t applied = 0;
+    std::vector<uint8_t> record;
+    for(size_t index = 0;; ++index)
+    {
+        RecordSize size;
+        in.read(reinterpret_cast<char*>(&size), sizeof(RecordSize));
+        if(in.gcount() == 0)
+            break;
+        if(in.gcount() != sizeof(RecordSize))
+        {
+            LOG(WARNING) << "Journal " << segment << " ends with a truncated record";
+            break;
+        }
+        record.resize(size);
+        in.read(reinterpret_cast<char*>(record.data()), size);
+        if(in.gcount() != std::streamsize(size))
+        {
+            LOG(WARNING) << "Journal " << segment << " ends with a truncated record";
+            break;
+        }
+
+        bool success = false;
+        try
+        {
+            BinaryInputBuffer buffer(record);
+            std::istream stream(&buffer);
+            boost::archive::binary_iarchive ia(stream, boost::archive::no_header);
+            success = applyRecord(graph, ia);
+        }
+        catch(const boost::archive::archive_exception& e)
+        {
+            throw InvalidJournalException(segment, "record " + std::to_string(index) + " is corrupt: " + e.what());
+        }
+        if(success)
+            ++applied;
+        else
+            LOG(ERROR) << "Failed to apply record " << index << " of journal " << segment;
+    }
+    return applied;
+}
+
+void GraphJournal::compact(const std::string& baseSnapshot,
+                           const std::vector<std::string>& segments,
+                           const std::string& newSnapshot,
+                           unsigned threads)
+{
+    EnvireGraph graph;
+    if(!baseSnapshot.empty())
+        GraphSnapshot::load(graph, baseSnapshot);
+    for(const std::string& segment : segments)
+        replay(graph, segment);
+
+    //the base snapshot is still mapped and might be the same file as the
+    //new one. Write to a temporary file and replace the snapshot atomically.
+    const std::string tmp = newSnapshot + ".tmp";
+    GraphSnapshot::save(graph, tmp, threads);
+    if(std::rename(tmp.c_str(), newSnapshot.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        throw std::ios_base::failure("Unable to replace snapshot " + newSnapshot);
+    }
+}
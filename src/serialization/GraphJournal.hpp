@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/events/GraphEventDispatcher.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace envire { namespace core
+{
+    class EnvireGraph;
+
+    /**Records the events of an EnvireGraph in an append-only journal.
+     *
+     * Each event is stored as one length prefixed record, together with the
+     * data that is needed to redo it (edge transforms and serialized items).
+     * The cost of persisting the graph thus depends on the rate of change
+     * instead of the size of the graph. EnvireGraph::replay() applies the
+     * records to a graph. A record that has only partially been written,
+     * e.g. due to a crash, ends the journal.
+     *
+     * A typical setup saves a base snapshot using EnvireGraph::saveSnapshot()
+     * and attaches a journal afterwards. The state of the graph can then be
+     * restored by loading the base snapshot and replaying the journal.
+     * rotate() continues the journal in a new segment, older segments can be
+     * folded into a new base snapshot using compact(). This does not involve
+     * the journaled graph and can be done in the background.
+     *
+     * Events of items that are not serializable are not recorded.
+     * Items that have been modified are replayed by replacing the item.
+     * Removing an item that does not exist in the replayed graph is ignored.
+     * Records larger than 4 GB cannot be stored and are dropped.
+     *
+     * @note Do not replay a journal into a graph that is journaled by the
+     *       same journal. */
+    class GraphJournal : public GraphEventDispatcher
+    {
+    public:
+        static const uint32_t VERSION = 1;
+
+        /**Subscribes to @p graph and appends all events to @p segment.
+         * @throw std::ios_base::failure if the segment cannot be opened*/
+        GraphJournal(EnvireGraph* graph, const std::string& segment);
+        virtual ~GraphJournal();
+
+        /**Continues the journal in @p segment.
+         * @throw std::ios_base::failure if the segment cannot be opened*/
+        void rotate(const std::string& segment);
+
+        /** @return the segment that is currently written */
+        const std::string& getSegment() const { return segment; }
+
+        /** @return the number of records written to the current segment */
+        size_t getRecordCount() const { return recordCount; }
+
+        /**Applies the records in @p segment to @p graph.
+         * @return the number of records that have been applied
+         * @throw InvalidJournalException if @p segment is not a journal*/
+        static size_t replay(EnvireGraph& graph, const std::string& segment);
+
+        /**Loads @p baseSnapshot, replays @p segments in order and stores the
+         * result in @p newSnapshot.
+         * @param baseSnapshot may be empty if the journal starts with an
+         *                     empty graph.
+         * @param threads number of threads used to save the new snapshot */
+        static void compact(const std::string& baseSnapshot,
+                            const std::vector<std::string>& segments,
+                            const std::string& newSnapshot,
+                            unsigned threads = 1);
+
+    protected:
+        virtual void edgeAdded(const EdgeAddedEvent& e);
+        virtual void edgeRemoved(const EdgeRemovedEvent& e);
+        virtual void edgeModified(const EdgeModifiedEvent& e);
+        virtual void frameAdded(const FrameAddedEvent& e);
+        virtual void frameRemoved(const FrameRemovedEvent& e);
+        virtual void itemAdded(const ItemAddedEvent& e);
+        virtual void itemRemoved(const ItemRemovedEvent& e);
+        virtual void itemModified(const ItemModifiedEvent& e);
+
+    private:
+        void open(const std::string& segment);
+
+        /**Prefixes @p record with its length, appends it to the segment and
+         * flushes the segment */
+        void append(const std::vector<uint8_t>& record);
+
+        EnvireGraph* graph;
+        std::string segment;
+        std::ofstream out;
+        size_t recordCount;
+        std::vector<uint8_t> record;
+    };
+}}
@@ -0,0 +1,475 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "GraphSnapshot.hpp"
+
+#include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/graph/GraphExceptions.hpp>
+#include <envire_core/serialization/Serialization.hpp>
+
+#include <fstream>
+#include <cstring>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <exception>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+#include <glog/logging.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace envire::core;
+
+namespace
+{
+    const char MAGIC[8] = {'E', 'N', 'V', 'I', 'R', 'E', 'S', 'N'};
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct SnapshotHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t frameCount;
+        uint64_t edgeCount;
+        uint64_t frameTableOffset;
+        uint64_t edgeTableOffset;
+        uint64_t stringTableOffset;
+        uint64_t stringTableSize;
+        uint8_t environmentUuid[16];
+        uint64_t environmentNameOffset;
+        uint64_t environmentNameLength;
+    };
+
+    struct FrameEntry
+    {
+        uint64_t idOffset; /** relative to the string table */
+        uint64_t idLength;
+        uint64_t itemsOffset; /** absolute */
+        uint64_t itemsSize;
+        uint64_t itemCount;
+    };
+
+    struct EdgeEntry
+    {
+        uint32_t origin; /** index into the frame table */
+        uint32_t target;
+        int64_t time; /** microseconds */
+        double translation[3];
+        double orientation[4]; /** x, y, z, w */
+        double cov[36]; /** column major */
+    };
+
+    /**Length prefix of an item record */
+    typedef uint64_t RecordSize;
+
+    uint64_t align8(uint64_t offset)
+    {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    void writePadding(std::ofstream& out)
+    {
+        static const char zeros[8] = {0};
+        const uint64_t pos = out.tellp();
+        out.write(zeros, align8(pos) - pos);
+    }
+
+    /**Appends the item records of @p frame to @p chunk.
+     * @return the number of records written */
+    uint64_t serializeItems(const Frame& frame, std::vector<uint8_t>& chunk)
+    {
+        uint64_t count = 0;
+        frame.visitItems([&](const ItemBase::Ptr& item)
+        {
+            if(!Serialization::isSerializable(item))
+                return;
+            //the item is serialized behind its length prefix, which is
+            //filled in afterwards
+            const size_t start = chunk.size();
+            chunk.resize(start + sizeof(RecordSize));
+            if(!Serialization::saveToBinary(chunk, item))
+                throw std::runtime_error("Failed to serialize item " + item->getIDString());
+            const RecordSize size = chunk.size() - start - sizeof(RecordSize);
+            std::memcpy(chunk.data() + start, &size, sizeof(RecordSize));
+            ++count;
+        });
+        return count;
+    }
+
+    /**Calls @p func(i) for every i in [0, count) using @p threads threads.
+     * Indices are handed out dynamically because the work per index
+     * varies a lot (frames with few small vs. many large items).
+     * The first exception thrown by @p func is rethrown after all threads
+     * have finished. */
+    template <class Func>
+    void parallelFor(size_t count, unsigned threads, Func func)
+    {
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        boost::mutex errorMutex;
+        auto worker = [&]()
+        {
+            for(size_t i = next++; i < count; i = next++)
+            {
+                try
+                {
+                    func(i);
+                }
+                catch(...)
+                {
+                    boost::lock_guard<boost::mutex> guard(errorMutex);
+                    if(!error)
+                        error = std::current_exception();
+                    next = count;
+                }
+            }
+        };
+
+        boost::thread_group group;
+        for(unsigned t = 1; t < threads && t < count; ++t)
+            group.create_thread(worker);
+        worker();
+        group.join_all();
+        if(error)
+            std::rethrow_exception(error);
+    }
+
+    /** @return true if [@p offset, @p offset + @p length) lies within
+     *          [0, @p size). Does not overflow for any input. */
+    bool inBounds(uint64_t offset, uint64_t length, uint64_t size)
+    {
+        return length <= size && offset <= size - length;
+    }
+
+    /**Read only mapping of a snapshot file. Unmapped on destruction. */
+    class MappedFile
+    {
+    public:
+        MappedFile(const std::string& file) : data(NULL), size(0)
+        {
+            const int fd = ::open(file.c_str(), O_RDONLY);
+            if(fd < 0)
+                throw InvalidSnapshotException(file, std::strerror(errno));
+            struct stat st;
+            if(::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw InvalidSnapshotException(file, std::strerror(errno));
+            }
+            size = st.st_size;
+            if(size < sizeof(SnapshotHeader))
+            {
+                ::close(fd);
+                throw InvalidSnapshotException(file, "file too small");
+            }
+            void* addr = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            //the mapping stays valid after closing the descriptor
+            ::close(fd);
+            if(addr == MAP_FAILED)
+                throw InvalidSnapshotException(file, std::strerror(errno));
+            data = static_cast<const uint8_t*>(addr);
+        }
+
+        ~MappedFile()
+        {
+            ::munmap(const_cast<uint8_t*>(data), size);
+        }
+
+        const uint8_t* data;
+        size_t size;
+
+    private:
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+    };
+
+    /**Deserializes the item records of one frame from the mapped file */
+    class SnapshotPendingItems : public PendingItems
+    {
+    public:
+        SnapshotPendingItems(const boost::shared_ptr<MappedFile>& file,
+                             const FrameEntry& entry,
+                             ItemContentsObserver* observer) :
+            file(file), entry(entry), observer(observer) {}
+
+        virtual void load(Frame& frame)
+        {
+            const uint8_t* pos = file->data + entry.itemsOffset;
+            const uint8_t* end = pos + entry.itemsSize;
+            for(uint64_t i = 0; i < entry.itemCount; ++i)
+            {
+                if(pos + sizeof(RecordSize) > end)
+                    throw std::runtime_error("Truncated item block in frame " + frame.getId());
+                RecordSize size;
+                std::memcpy(&size, pos, sizeof(RecordSize));
+                pos += sizeof(RecordSize);
+                if(size > uint64_t(end - pos))
+                    throw std::runtime_error("Truncated item record in frame " + frame.getId());
+
+                ItemBase::Ptr item;
+                if(Serialization::loadFromBinary(pos, size, item))
+                {
+                    item->setFrame(frame.getId());
+                    item->addContentsObserver(observer);
+                    frame.items[item->getTypeIndex()].push_back(item);
+                }
+                else
+                    LOG(ERROR) << "Failed to load item " << i << " of frame " << frame.getId();
+                pos += size;
+            }
+        }
+
+    private:
+        boost::shared_ptr<MappedFile> file;
+        FrameEntry entry;
+        ItemContentsObserver* observer;
+    };
+}
+
+unsigned GraphSnapshot::defaultThreadCount()
+{
+    return std::max(1u, boost::thread::hardware_concurrency());
+}
+
+void GraphSnapshot::save(const EnvireGraph& graph, const std::string& file,
+                         unsigned threads)
+{
+    std::ofstream out;
+    out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    out.open(file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+    const Environment& env = graph.graph()[boost::graph_bundle];
+
+    //collect frames and the string table
+    std::vector<EnvireGraph::vertex_descriptor> vertices;
+    std::unordered_map<EnvireGraph::vertex_descriptor, uint32_t> vertexIndex;
+    std::vector<FrameEntry> frames;
+    std::string strings;
+    EnvireGraph::vertex_iterator vIt, vEnd;
+    for(boost::tie(vIt, vEnd) = graph.getVertices(); vIt != vEnd; ++vIt)
+    {
+        const FrameId& id = graph.getFrameId(*vIt);
+        FrameEntry entry;
+        std::memset(&entry, 0, sizeof(FrameEntry));
+        entry.idOffset = strings.size();
+        entry.idLength = id.size();
+        strings += id;
+        vertexIndex[*vIt] = vertices.size();
+        vertices.push_back(*vIt);
+        frames.push_back(entry);
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(SnapshotHeader));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.frameCount = frames.size();
+    header.edgeCount = graph.num_edges();
+    std::copy(env.uuid.begin(), env.uuid.end(), header.environmentUuid);
+    header.environmentNameOffset = strings.size();
+    header.environmentNameLength = env.name.size();
+    strings += env.name;
+
+    //placeholder, rewritten once all offsets are known
+    out.write(reinterpret_cast<const char*>(&header), sizeof(SnapshotHeader));
+    writePadding(out);
+
+    header.stringTableOffset = out.tellp();
+    header.stringTableSize = strings.size();
+    out.write(strings.data(), strings.size());
+    writePadding(out);
+
+    //placeholder, rewritten once the item blocks have been written
+    header.frameTableOffset = out.tellp();
+    out.write(reinterpret_cast<const char*>(frames.data()), frames.size() * sizeof(FrameEntry));
+    writePadding(out);
+
+    header.edgeTableOffset = out.tellp();
+    EnvireGraph::edge_iterator eIt, eEnd;
+    for(boost::tie(eIt, eEnd) = graph.getEdges(); eIt != eEnd; ++eIt)
+    {
+        const Transform& tf = graph.getEdgeProperty(*eIt);
+        EdgeEntry entry;
+        entry.origin = vertexIndex[graph.getSourceVertex(*eIt)];
+        entry.target = vertexIndex[graph.getTargetVertex(*eIt)];
+        entry.time = tf.time.microseconds;
+        for(int i = 0; i < 3; ++i)
+            entry.translation[i] = tf.transform.translation[i];
+        entry.orientation[0] = tf.transform.orientation.x();
+        entry.orientation[1] = tf.transform.orientation.y();
+        entry.orientation[2] = tf.transform.orientation.z();
+        entry.orientation[3] = tf.transform.orientation.w();
+        for(int i = 0; i < 36; ++i)
+            entry.cov[i] = tf.transform.cov.data()[i];
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(EdgeEntry));
+    }
+    writePadding(out);
+
+    auto writeChunk = [&](FrameEntry& entry, const std::vector<uint8_t>& chunk)
+    {
+        entry.itemsOffset = out.tellp();
+        entry.itemsSize = chunk.size();
+        out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+        writePadding(out);
+    };
+
+    if(threads <= 1)
+    {
+        //item blocks are streamed frame by frame
+        std::vector<uint8_t> chunk;
+        for(size_t i = 0; i < vertices.size(); ++i)
+        {
+            chunk.clear();
+            frames[i].itemCount = serializeItems(graph.graph()[vertices[i]], chunk);
+            writeChunk(frames[i], chunk);
+        }
+    }
+    else
+    {
+        //the item blocks are independent of each other. They are serialized
+        //concurrently and written in order afterwards. The frame table
+        //stitches them together.
+        std::vector<std::vector<uint8_t>> chunks(vertices.size());
+        parallelFor(vertices.size(), threads, [&](size_t i)
+        {
+            frames[i].itemCount = serializeItems(graph.graph()[vertices[i]], chunks[i]);
+        });
+        for(size_t i = 0; i < vertices.size(); ++i)
+        {
+            writeChunk(frames[i], chunks[i]);
+            std::vector<uint8_t>().swap(chunks[i]);
+        }
+    }
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(SnapshotHeader));
+    out.seekp(header.frameTableOffset);
+    out.write(reinterpret_cast<const char*>(frames.data()), frames.size() * sizeof(FrameEntry));
+    out.close();
+}
+
+void GraphSnapshot::load(EnvireGraph& graph, const std::string& file, unsigned threads)
+{
+    load(graph, file);
+
+    std::vector<Frame*> pending;
+    EnvireGraph::vertex_iterator it, end;
+    for(boost::tie(it, end) = graph.getVertices(); it != end; ++it)
+    {
+        Frame& frame = graph.graph()[*it];
+        if(frame.hasPendingItems())
+            pending.push_back(&frame);
+    }
+    //each frame is only touched by one thread
+    parallelFor(pending.size(), threads, [&](size_t i)
+    {
+        pending[i]->loadPendingItems();
+    });
+}
+
+void GraphSnapshot::load(EnvireGraph& graph, const std::string& file)
+{
+    if(graph.num_vertices() > 0)
+        throw GraphNotEmptyException();
+
+    boost::shared_ptr<MappedFile> mapped(new MappedFile(file));
+    const uint8_t* data = mapped->data;
+    const uint64_t size = mapped->size;
+
+    SnapshotHeader header;
+    std::memcpy(&header, data, sizeof(SnapshotHeader));
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw InvalidSnapshotException(file, "bad magic");
+    if(header.byteOrder != BYTE_ORDER_MARK)
+        throw InvalidSnapshotException(file, "byte order mismatch");
+    if(header.version != VERSION)
+        throw InvalidSnapshotException(file, "unsupported version " + std::to_string(header.version));
+    if(!inBounds(header.stringTableOffset, header.stringTableSize, size) ||
+       header.frameTableOffset > size || header.frameCount > (size - header.frameTableOffset) / sizeof(FrameEntry) ||
+       header.edgeTableOffset > size || header.edgeCount > (size - header.edgeTableOffset) / sizeof(EdgeEntry) ||
+       !inBounds(header.environmentNameOffset, header.environmentNameLength, header.stringTableSize))
+        throw InvalidSnapshotException(file, "table out of bounds");
+
+    const char* strings = reinterpret_cast<const char*>(data + header.stringTableOffset);
+    //the tables are 8 byte aligned and mmap returns page aligned memory,
+    //thus the entries can be accessed in place
+    const FrameEntry* frames = reinterpret_cast<const FrameEntry*>(data + header.frameTableOffset);
+    const EdgeEntry* edges = reinterpret_cast<const EdgeEntry*>(data + header.edgeTableOffset);
+
+    //validate all entries first, an invalid snapshot should not leave a
+    //partially loaded graph behind
+    for(uint64_t i = 0; i < header.frameCount; ++i)
+    {
+        const FrameEntry& entry = frames[i];
+        if(!inBounds(entry.idOffset, entry.idLength, header.stringTableSize) ||
+           !inBounds(entry.itemsOffset, entry.itemsSize, size))
+            throw InvalidSnapshotException(file, "frame entry out of bounds");
+    }
+    for(uint64_t i = 0; i < header.edgeCount; ++i)
+    {
+        const EdgeEntry& entry = edges[i];
+        if(entry.origin >= header.frameCount || entry.target >= header.frameCount)
+            throw InvalidSnapshotException(file, "edge entry out of bounds");
+    }
+
+    Environment& env = graph.graph()[boost::graph_bundle];
+    std::copy(header.environmentUuid, header.environmentUuid + 16, env.uuid.begin());
+    env.name.assign(strings + header.environmentNameOffset, header.environmentNameLength);
+
+    //the graph is built without publishing events, like the regular
+    //deserialization does
+    std::vector<EnvireGraph::vertex_descriptor> vertices(header.frameCount);
+    for(uint64_t i = 0; i < header.frameCount; ++i)
+    {
+        const FrameEntry& entry = frames[i];
+        const FrameId id(strings + entry.idOffset, entry.idLength);
+        vertices[i] = graph.GraphBase<Frame, Transform>::add_vertex(id, Frame(id));
+        if(entry.itemCount > 0)
+            graph.graph()[vertices[i]].setPendingItems(
+                boost::make_shared<SnapshotPendingItems>(mapped, entry, &graph));
+    }
+
+    for(uint64_t i = 0; i < header.edgeCount; ++i)
+    {
+        const EdgeEntry& entry = edges[i];
+        Transform tf;
+        tf.time = base::Time::fromMicroseconds(entry.time);
+        tf.transform.translation = base::Position(entry.translation[0], entry.translation[1], entry.translation[2]);
+        tf.transform.orientation = base::Orientation(entry.orientation[3], entry.orientation[0],
+                                                     entry.orientation[1], entry.orientation[2]);
+        for(int j = 0; j < 36; ++j)
+            tf.transform.cov.data()[j] = entry.cov[j];
+        boost::add_edge(vertices[entry.origin], vertices[entry.target], tf, graph.graph());
+    }
+}
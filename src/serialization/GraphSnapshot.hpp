@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace envire { namespace core
+{
+    class EnvireGraph;
+
+    /**Memory mappable binary snapshot format for the EnvireGraph.
+     *
+     * In contrast to EnvireGraph::saveToFile() the snapshot does not need to
+     * be parsed sequentially. It consists of fixed size tables that can be
+     * read directly from the mapped file:
+     *
+     * @code
+     *   Header       magic, version, table offsets and the environment
+     *   Strings      frame ids and the environment name
+     *   Frame table  one entry per frame: id and location of its item block
+     *   Edge table   one entry per directed edge: frame indices and transform
+     *   Item blocks  per frame: a sequence of length prefixed item records.
+     *                Each record is the output of Serialization::saveToBinary()
+     * @endcode
+     *
+     * All values are stored in host byte order, the header contains a marker
+     * to detect byte order mismatches.
+     *
+     * When loading, the topology (frames and edges) is built from the tables
+     * right away. The items of a frame are deserialized on first access of
+     * the frame's items. The file stays mapped until all items have been
+     * loaded or the graph has been destroyed. */
+    class GraphSnapshot
+    {
+    public:
+        static const uint32_t VERSION = 1;
+
+        /**@return the number of hardware threads, at least 1 */
+        static unsigned defaultThreadCount();
+
+        /**Writes @p graph to @p file.
+         * Items that are not serializable are skipped.
+         * If @p threads is greater than one, the items of different frames
+         * are serialized concurrently. In that case all item blocks are kept
+         * in memory until they have been written.
+         * @throw std::ios_base::failure if the file operation failed
+         * @throw std::runtime_error if a serializable item could not be saved*/
+        static void save(const EnvireGraph& graph, const std::string& file,
+                         unsigned threads = 1);
+
+        /**Loads the snapshot in @p file into @p graph.
+         * No events are published while loading.
+         * @throw GraphNotEmptyException if @p graph contains frames
+         * @throw InvalidSnapshotException if @p file is not a valid snapshot*/
+        static void load(EnvireGraph& graph, const std::string& file);
+
+        /**Loads the snapshot in @p file into @p graph and deserializes the
+         * items of all frames immediately, using @p threads threads.
+         * Frames are distributed between the threads, the items of a single
+         * frame are loaded by one thread.
+         * @throw GraphNotEmptyException if @p graph contains frames
+         * @throw InvalidSnapshotException if @p file is not a valid snapshot*/
+        static void load(EnvireGraph& graph, const std::string& file, unsigned threads);
+    };
+}}
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/serialization/LoadOptions.hpp>
+#include <envire_core/serialization/Serialization.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace envire { namespace core
+{
+
+/**
+ * @brief Applies LoadOptions while a graph archive is loaded.
+ *
+ * One filter is attached to each input archive using the boost archive
+ * helper mechanism, like the ClassNameDictionary. Without options
+ * everything is loaded.
+ * @see Frame::load()
+ */
+class ItemLoadFilter
+{
+public:
+    /** An item list that has been read from the archive but has not been
+     *  deserialized, yet */
+    struct Record
+    {
+        /** Is resolved when the record is loaded */
+        std::string class_name;
+        uint64_t count;
+        std::vector<uint8_t> data;
+    };
+
+    /** Treatment of an item list */
+    enum Action
+    {
+        LOAD,
+        SKIP,
+        /** Keep the record, it is decided after the topology has been loaded */
+        DEFER
+    };
+
+    ItemLoadFilter() : options(NULL), frameAccepted(true) {}
+
+    /** @param options are used for the archive, NULL loads everything.
+     *                 Are not copied. */
+    void setOptions(const LoadOptions* options) { this->options = options; }
+
+    /** Is called before the items of @p frame are loaded */
+    void beginFrame(const FrameId& frame)
+    {
+        frameAccepted = options == NULL || options->acceptsFrame(frame);
+        currentFrame = frame;
+        deferred.clear();
+        deferredItems.clear();
+    }
+
+    /** @return the frame whose items are currently loaded */
+    const FrameId& getFrame() const { return currentFrame; }
+
+    /** @return the treatment of the item list of class @p class_name in the
+     *          current frame */
+    Action getAction(const std::string& class_name) const
+    {
+        if(options == NULL)
+            return LOAD;
+        if(!frameAccepted || !options->acceptsItemClass(class_name))
+            return SKIP;
+        //the subtree is only known once all edges have been loaded
+        return options->subtreeRoot.empty() ? LOAD : DEFER;
+    }
+
+    /** Applies @p action to @p items that already have been loaded, because
+     *  the archive layout does not allow skipping them.
+     *  Deferred items are moved to deferredItems.
+     *  @return true if @p items should be added to the frame */
+    bool applyToLoaded(Action action, std::vector<ItemBase::Ptr>& items)
+    {
+        if(action == LOAD)
+            return true;
+        if(action == DEFER)
+            deferredItems.push_back(std::move(items));
+        items.clear();
+        return false;
+    }
+
+    /** Reads @p size bytes of binary data from @p ar into @p data */
+    template <typename Archive>
+    static void read(Archive& ar, uint64_t size, std::vector<uint8_t>& data)
+    {
+        data.resize(size);
+        if(size > 0)
+            ar.load_binary(data.data(), size);
+    }
+
+    /** Skips @p size bytes of binary data of @p ar.
+     *  The data is read in small chunks to bound the memory usage. */
+    template <typename Archive>
+    void skip(Archive& ar, uint64_t size)
+    {
+        const uint64_t chunk_size = 64 * 1024;
+        buffer.resize(std::min(size, chunk_size));
+        while(size > 0)
+        {
+            const uint64_t chunk = std::min(size, chunk_size);
+            ar.load_binary(buffer.data(), chunk);
+            size -= chunk;
+        }
+    }
+
+    /** Item lists of the current frame that have been deferred */
+    std::vector<Record> deferred;
+
+    /** Item lists of the current frame that have been deferred after
+     *  loading them */
+    std::vector<std::vector<ItemBase::Ptr>> deferredItems;
+
+    /** Is reused for the item lists that are loaded immediately */
+    std::vector<uint8_t> buffer;
+
+    /**
+     * @brief Key of the filter in the helper collection of an archive.
+     * @see ClassNameDictionary::helperId()
+     */
+    static void* helperId()
+    {
+        static char id;
+        return &id;
+    }
+
+private:
+    const LoadOptions* options;
+    bool frameAccepted;
+    FrameId currentFrame;
+};
+
+}}
@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <envire_core/items/ItemBase.hpp>
+#include <envire_core/items/ItemMetadata.hpp>
+#include <unordered_set>
+#include <limits>
+#include <string>
+
+namespace envire { namespace core
+{
+
+/**
+ * @brief Selects the parts of a graph archive that are loaded by
+ * EnvireGraph::loadFromFile().
+ *
+ * The topology (frames and transforms) is always loaded completely, the
+ * options only select the items. Item records that are not selected are
+ * skipped without constructing the items, i.e. neither the items nor their
+ * plugin libraries are loaded.
+ * The default options load everything.
+ */
+struct LoadOptions
+{
+    LoadOptions() : subtreeDepth(std::numeric_limits<std::size_t>::max()),
+                    inclusive(true), skipItems(false) {}
+
+    /** Only the items of these frames are loaded. Empty means all frames */
+    std::unordered_set<FrameId> frames;
+
+    /** If set, only the items of the frames in the tree below this frame
+     *  (including the frame itself) are loaded. The tree is limited to
+     *  @p subtreeDepth levels. */
+    FrameId subtreeRoot;
+    std::size_t subtreeDepth;
+
+    /** Class names of the item types, e.g. "envire::core::Item<Eigen::Vector3d>".
+     *  Empty means all types. */
+    std::unordered_set<std::string> itemClasses;
+
+    /** If true itemClasses is a white list, otherwise it is a black list */
+    bool inclusive;
+
+    /** If true no items are loaded at all, only the topology */
+    bool skipItems;
+
+    /** Adds the class name of the item type @p T to itemClasses.
+     *  @throw std::out_of_range if no metadata is registered for @p T */
+    template <class T>
+    void addItemType()
+    {
+        itemClasses.insert(ItemMetadataMapping::getMetadata(typeid(T)).className);
+    }
+
+    /** @return true if the items of @p frame should be loaded.
+     *  Does not consider the subtree. */
+    bool acceptsFrame(const FrameId& frame) const
+    {
+        return !skipItems && (frames.empty() || frames.count(frame) > 0);
+    }
+
+    /** @return true if items of the class @p class_name should be loaded */
+    bool acceptsItemClass(const std::string& class_name) const
+    {
+        if(skipItems)
+            return false;
+        if(itemClasses.empty())
+            return true;
+        return (itemClasses.count(class_name) > 0) == inclusive;
+    }
+};
+
+}}
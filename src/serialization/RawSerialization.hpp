@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#pragma once
+
+#include <boost/mpl/bool.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <Eigen/Core>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+
+namespace boost { namespace archive
+{
+    class binary_oarchive;
+    class binary_iarchive;
+}}
+
+namespace envire { namespace core
+{
+
+/**
+ * @brief Is true for types whose object representation can be stored as a
+ * raw byte block in binary archives.
+ * Trivially copyable types are detected automatically. Specialize this
+ * trait to opt out, e.g. for trivially copyable types that contain pointers.
+ */
+template <class T>
+struct IsTriviallySerializable : std::integral_constant<bool,
+    std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value> {};
+
+/** Fixed size Eigen matrices are stored as raw block as well */
+template <class S, int R, int C, int O, int MR, int MC>
+struct IsTriviallySerializable<Eigen::Matrix<S, R, C, O, MR, MC>> : std::integral_constant<bool,
+    R != Eigen::Dynamic && C != Eigen::Dynamic && IsTriviallySerializable<S>::value> {};
+
+/**
+ * @brief Stores the data of trivially serializable types as a single raw
+ * byte block.
+ * value is true if the fast path is available for @p T.
+ */
+template <class T>
+struct RawSerialization
+{
+    static const bool value = IsTriviallySerializable<T>::value;
+
+    template <class Archive>
+    static void save(Archive& ar, const T& data)
+    {
+        ar.save_binary(&data, sizeof(T));
+    }
+
+    template <class Archive>
+    static void load(Archive& ar, T& data)
+    {
+        ar.load_binary(&data, sizeof(T));
+    }
+};
+
+/** Contiguous containers are stored as element count and raw byte block */
+template <class T, class Alloc>
+struct RawSerialization<std::vector<T, Alloc>>
+{
+    //std::vector<bool> is not contiguous
+    static const bool value = IsTriviallySerializable<T>::value && !std::is_same<T, bool>::value;
+
+    template <class Archive>
+    static void save(Archive& ar, const std::vector<T, Alloc>& data)
+    {
+        const uint64_t size = data.size();
+        ar.save_binary(&size, sizeof(size));
+        if(size > 0)
+            ar.save_binary(data.data(), size * sizeof(T));
+    }
+
+    template <class Archive>
+    static void load(Archive& ar, std::vector<T, Alloc>& data)
+    {
+        uint64_t size;
+        ar.load_binary(&size, sizeof(size));
+        data.resize(size);
+        if(size > 0)
+            ar.load_binary(data.data(), size * sizeof(T));
+    }
+};
+
+namespace detail
+{
+    template <class Archive, class T>
+    void serializeRaw(Archive& ar, T& data, boost::mpl::true_ /*saving*/)
+    {
+        RawSerialization<T>::save(ar, data);
+    }
+
+    template <class Archive, class T>
+    void serializeRaw(Archive& ar, T& data, boost::mpl::false_ /*loading*/)
+    {
+        RawSerialization<T>::load(ar, data);
+    }
+
+    template <class Archive, class T>
+    void serializeData(Archive& ar, const char* name, T& data, bool raw, std::true_type /*available*/)
+    {
+        if(raw)
+            serializeRaw(ar, data, typename Archive::is_saving());
+        else
+            ar & boost::serialization::make_nvp(name, data);
+    }
+
+    template <class Archive, class T>
+    void serializeData(Archive& ar, const char* name, T& data, bool raw, std::false_type /*available*/)
+    {
+        ar & boost::serialization::make_nvp(name, data);
+    }
+}
+
+/**
+ * @brief Serializes @p data as raw byte block if the archive is a binary
+ * archive and RawSerialization supports the type. Otherwise boost
+ * serialization is used.
+ *
+ * @param raw false to always use boost serialization, e.g. when loading
+ *            archives that have been written without the fast path
+ */
+template <class Archive, class T>
+void serializeData(Archive& ar, const char* name, T& data, bool raw = true)
+{
+    typedef std::integral_constant<bool, RawSerialization<T>::value &&
+        (std::is_same<Archive, boost::archive::binary_oarchive>::value ||
+         std::is_same<Archive, boost::archive::binary_iarchive>::value)> available;
+    detail::serializeData(ar, name, data, raw, available());
+}
+
+}}
@@ -31,6 +31,12 @@
 #include <envire_core/serialization/BinaryBufferHelper.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/make_shared.hpp>
+#include <unordered_map>
+#include <typeindex>
+#include <envire_core/util/Demangle.hpp>
 
 #ifdef CMAKE_ENABLE_PLUGINS
     #include <envire_core/plugin/ClassLoader.hpp>
@@ -40,8 +46,12 @@ using namespace envire::core;
 
 bool Serialization::saveToBinary(std::vector< uint8_t >& binary, const ItemBase::Ptr& item)
 {
-    binary.reserve(1000000);
     BinaryOutputBuffer buffer(&binary);
+    return saveToBinary(buffer, item);
+}
+
+bool Serialization::saveToBinary(std::streambuf& buffer, const ItemBase::Ptr& item)
+{
     std::ostream ostream(&buffer);
     boost::archive::binary_oarchive oa(ostream);
     return save(oa, item);
@@ -49,50 +59,129 @@ bool Serialization::saveToBinary(std::vector< uint8_t >& binary, const ItemBase:
 
 bool Serialization::loadFromBinary(const std::vector< uint8_t >& binary, ItemBase::Ptr& item)
 {
-    BinaryInputBuffer buffer(binary);
+    return loadFromBinary(binary.data(), binary.size(), item);
+}
+
+bool Serialization::loadFromBinary(const uint8_t* data, std::size_t size, ItemBase::Ptr& item)
+{
+    BinaryInputBuffer buffer(data, size);
     std::istream istream(&buffer);
     boost::archive::binary_iarchive ia(istream);
     return load(ia, item);
 }
 
+bool Serialization::saveItemsToBinary(std::vector< uint8_t >& binary, const HandlePtr& handle,
+                                      const std::vector<ItemBase::Ptr>& items)
+{
+    BinaryOutputBuffer buffer(&binary);
+    std::ostream ostream(&buffer);
+    boost::archive::binary_oarchive oa(ostream);
+    for(const ItemBase::Ptr& item : items)
+    {
+        if(!handle->save(oa, item))
+            return false;
+    }
+    return true;
+}
+
+bool Serialization::loadItemsFromBinary(const uint8_t* data, std::size_t size, const HandlePtr& handle,
+                                        uint64_t count, std::vector<ItemBase::Ptr>& items)
+{
+    try
+    {
+        BinaryInputBuffer buffer(data, size);
+        std::istream istream(&buffer);
+        boost::archive::binary_iarchive ia(istream);
+        items.reserve(items.size() + count);
+        for(uint64_t i = 0; i < count; ++i)
+        {
+            ItemBase::Ptr item;
+            if(!handle->load(ia, item))
+                return false;
+            items.push_back(item);
+        }
+        return true;
+    }
+    catch(const std::exception& e)
+    {
+        LOG(ERROR) << "Caught exception while trying to load items: " << e.what();
+    }
+    return false;
+}
+
 bool Serialization::isSerializable(const ItemBase::Ptr& item)
 {
-    std::string class_name;
-    if (!item->getClassName(class_name))
+    return getItemTypeInfo(*item)->serializable;
+}
+
+Serialization::ItemTypeInfoPtr Serialization::getItemTypeInfo(const ItemBase& item)
+{
+    typedef std::unordered_map<std::type_index, ItemTypeInfoPtr> TypeCache;
+    static TypeCache cache;
+    static boost::shared_mutex cache_mutex;
+
+    const std::type_index type = item.getTypeIndex();
     {
-        /* Load all available plugins of type ItemBase.
-         * Note: The shared library of the Item has to be dynamicly loaded or linked
-         * in order to get a valid class name. Since this is here not jet the case all
+        boost::shared_lock<boost::shared_mutex> guard(cache_mutex);
+        TypeCache::const_iterator it = cache.find(type);
+        // negative results are only valid until new handles are registered
+        if(it != cache.end() && (it->second->serializable || it->second->generation == getHandleGeneration()))
+            return it->second;
+    }
+
+    // resolve without holding the cache lock, resolving might load plugins
+    boost::shared_ptr<ItemTypeInfo> info = resolveItemType(item);
+    // plugins loaded during the resolution must not invalidate the result
+    info->generation = getHandleGeneration();
+    boost::unique_lock<boost::shared_mutex> guard(cache_mutex);
+    cache[type] = info;
+    return info;
+}
+
+boost::shared_ptr<Serialization::ItemTypeInfo> Serialization::resolveItemType(const ItemBase& item)
+{
+    boost::shared_ptr<ItemTypeInfo> info = boost::make_shared<ItemTypeInfo>();
+    info->serializable = false;
+    std::string& class_name = info->class_name;
+    if (!item.getClassName(class_name))
+    {
+        /* Note: The shared library of the Item has to be dynamicly loaded or linked
+         * in order to get a valid class name. Try the library that is indexed for
+         * the embedded type first. The embedded type names in the plugin xml files
+         * might differ from the demangled names (e.g. typedefs), in that case all
          * plugin libraries have to be loaded. */
-        loadAllPluginLibraries();
+        if (!loadPluginLibraryFor(*item.getEmbeddedTypeInfo()) || !item.getClassName(class_name))
+            loadAllPluginLibraries();
 
-        if (!item->getClassName(class_name))
+        if (!item.getClassName(class_name))
         {
-            LOG(INFO) << "Can't serialize item with embedded type " << item->getEmbeddedTypeInfo()->name() << ", it provides not class name. "
+            LOG(INFO) << "Can't serialize item with embedded type " << item.getEmbeddedTypeInfo()->name() << ", it provides not class name. "
                       << "Did you forget to register the Item with the ENVIRE_REGISTER_ITEM macro?";
-            return false;
+            return info;
         }
     }
 
     // try to get handle
-    if (hasHandle(class_name))
-        return true;
+    if (getHandle(class_name, info->handle) && info->handle)
+    {
+        info->serializable = true;
+        return info;
+    }
 
     // load plugin lib
     if (!loadPluginLibrary(class_name))
     {
         LOG(INFO) << "Failed to load plugin library for item " << class_name;
-        return false;
+        return info;
     }
 
     // try to get handle
-    if (hasHandle(class_name))
-        return true;
+    if (getHandle(class_name, info->handle) && info->handle)
+        info->serializable = true;
     else
         LOG(INFO) << "Library has been loaded but can't find a serialization handle for " << class_name << "."
                 << "Did you forget to register the Item with the ENVIRE_REGISTER_ITEM macro?";
-
-    return false;
+    return info;
 }
 
 Serialization::HandleMap& Serialization::getHandleMap()
@@ -101,20 +190,37 @@ Serialization::HandleMap& Serialization::getHandleMap()
     return handle_map;
 }
 
+std::recursive_mutex& Serialization::getHandleMutex()
+{
+    //function local static, handles are registered during static initialization
+    static std::recursive_mutex handle_mutex;
+    return handle_mutex;
+}
+
+std::atomic<uint64_t>& Serialization::getHandleGeneration()
+{
+    static std::atomic<uint64_t> generation(0);
+    return generation;
+}
+
 void Serialization::registerHandle(const std::string& plugin_name, Serialization::HandlePtr& handle)
 {
+    std::lock_guard<std::recursive_mutex> guard(getHandleMutex());
     HandleMap& handle_map = getHandleMap();
     handle_map[plugin_name] = handle;
+    ++getHandleGeneration();
 }
 
 bool Serialization::hasHandle(const std::string& plugin_name)
 {
+    std::lock_guard<std::recursive_mutex> guard(getHandleMutex());
     HandleMap& handle_map = getHandleMap();
     return handle_map.find(plugin_name) != handle_map.end();
 }
 
 bool Serialization::getHandle(const std::string& plugin_name, Serialization::HandlePtr& handle)
 {
+    std::lock_guard<std::recursive_mutex> guard(getHandleMutex());
     HandleMap& handle_map = getHandleMap();
     HandleMap::iterator it = handle_map.find(plugin_name);
     if(it != handle_map.end())
@@ -125,10 +231,39 @@ bool Serialization::getHandle(const std::string& plugin_name, Serialization::Han
     return false;
 }
 
+bool Serialization::resolveHandle(const std::string& class_name, Serialization::HandlePtr& handle)
+{
+    // try to get handle
+    if(!hasHandle(class_name))
+    {
+        // load plugin lib
+        if(loadPluginLibrary(class_name))
+        {
+            // try to get handle
+            LOG(INFO) << "Successfully loaded plugin library for item " << class_name;
+            if(!hasHandle(class_name))
+            {
+                LOG(ERROR) << "Library has been loaded but can't find a serialization handle for " << class_name << "."
+                        << "Did you forget to register the Item with the ENVIRE_REGISTER_ITEM macro?";
+                return false;
+            }
+        }
+        else
+        {
+            LOG(ERROR) << "Failed to load plugin library for item " << class_name;
+            return false;
+        }
+    }
+    return getHandle(class_name, handle) && handle;
+}
+
 bool Serialization::loadPluginLibrary(const std::string& class_name)
 {
     #ifdef CMAKE_ENABLE_PLUGINS
         LOG(INFO) << "Trying to load plugin library for item " << class_name;
+        //the handle mutex must not be held here. The ClassLoader serializes
+        //the loading and the libraries register their handles while being
+        //loaded, which would invert the lock order.
         ClassLoader* loader = ClassLoader::getInstance();
         return loader->loadEnvireItemLibrary(class_name);
     #else
@@ -138,6 +273,16 @@ bool Serialization::loadPluginLibrary(const std::string& class_name)
     #endif
 }
 
+bool Serialization::loadPluginLibraryFor(const std::type_info& embedded_type)
+{
+    #ifdef CMAKE_ENABLE_PLUGINS
+        ClassLoader* loader = ClassLoader::getInstance();
+        return loader->loadEnvireItemLibraryFor(demangleTypeName(std::type_index(embedded_type)));
+    #else
+        return false;
+    #endif
+}
+
 bool Serialization::loadAllPluginLibraries()
 {
     #ifdef CMAKE_ENABLE_PLUGINS
@@ -28,11 +28,18 @@
 
 #include <envire_core/serialization/SerializationHandle.hpp>
 #include <envire_core/serialization/ItemHeader.hpp>
+#include <envire_core/serialization/ClassNameDictionary.hpp>
 #include <envire_core/items/ItemBase.hpp>
+#include <envire_core/util/Tracing.hpp>
 
 #include <boost/serialization/nvp.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost_serialization/DynamicSizeSerialization.hpp>
 #include <glog/logging.h>
 #include <map>
+#include <streambuf>
+#include <mutex>
+#include <atomic>
 
 namespace envire { namespace core
 {
@@ -43,13 +50,27 @@ namespace envire { namespace core
  * For this to work it is mandatory to call the ENVIRE_REGISTER_SERIALIZATION( classname )
  * macro in the source file of the inherited class.
  * ENVIRE_REGISTER_ITEM( classname ) will also call ENVIRE_REGISTER_SERIALIZATION( classname ).
+ * Items can be saved and loaded from multiple threads concurrently.
  */
 class Serialization
 {
+public:
     typedef boost::shared_ptr<SerializationHandle> HandlePtr;
     typedef std::map< std::string, HandlePtr > HandleMap;
 
-public:
+    /**
+     * @brief Result of the serialization handle resolution of an item type.
+     * Is immutable once created.
+     */
+    struct ItemTypeInfo
+    {
+        bool serializable;
+        std::string class_name;
+        HandlePtr handle;
+        /** Handle registrations when the type has been resolved */
+        uint64_t generation;
+    };
+    typedef boost::shared_ptr<const ItemTypeInfo> ItemTypeInfoPtr;
 
     /**
      * @brief Serializes an abstract item to a boost archive.
@@ -61,22 +82,20 @@ public:
     template <typename Archive>
     static bool save(Archive& ar, const ItemBase::Ptr& item)
     {
-        if(isSerializable(item))
+        ENVIRE_TRACE_SCOPE("Serialization::save");
+        const ItemTypeInfoPtr info = getItemTypeInfo(*item);
+        ENVIRE_TRACE_ARG("class", info->class_name);
+        if(info->serializable)
         {
-            std::string class_name;
-            HandlePtr handle;
             try
             {
-                if (item->getClassName(class_name) && getHandle(class_name, handle) && handle)
-                {
-                    ItemHeader header(class_name);
-                    ar << BOOST_SERIALIZATION_NVP(header);
-                    return handle->save(ar, item);
-                }
+                ItemHeader header(info->class_name);
+                ar << BOOST_SERIALIZATION_NVP(header);
+                return info->handle->save(ar, item);
             }
             catch(const std::runtime_error& e)
             {
-                LOG(ERROR) << "Caught exception while trying to save an item of type " << class_name;
+                LOG(ERROR) << "Caught exception while trying to save an item of type " << info->class_name;
             }
         }
 
@@ -92,37 +111,20 @@ public:
      * @param ar boost polymorphic iarchive
      * @param item pointer to the ItemBase class
      * @return true if successful
+     * @note Boost serialization allocates the item using Item<T>::operator new,
+     *       i.e. the memory is drawn from the ItemPool.
      */
     template <typename Archive>
     static bool load(Archive& ar, ItemBase::Ptr& item)
     {
+        ENVIRE_TRACE_SCOPE("Serialization::load");
         try
         {
             ItemHeader header;
             ar >> BOOST_SERIALIZATION_NVP(header);
-            // try to get handle
-            if(!hasHandle(header.class_name))
-            {
-                // load plugin lib
-                if(loadPluginLibrary(header.class_name))
-                {
-                    // try to get handle
-                    LOG(INFO) << "Successfully loaded plugin library for item " << header.class_name;
-                    if(!hasHandle(header.class_name))
-                    {
-                        LOG(ERROR) << "Library has been loaded but can't find a serialization handle for " << header.class_name << "."
-                                << "Did you forget to register the Item with the ENVIRE_REGISTER_ITEM macro?";
-                        return false;
-                    }
-                }
-                else
-                {
-                    LOG(ERROR) << "Failed to load plugin library for item " << header.class_name;
-                    return false;
-                }
-            }
+            ENVIRE_TRACE_ARG("class", header.class_name);
             HandlePtr handle;
-            if(getHandle(header.class_name, handle) && handle)
+            if(resolveHandle(header.class_name, handle))
                 return handle->load(ar, item);
             return false;
         }
@@ -133,6 +135,95 @@ public:
         return false;
     }
 
+    /**
+     * @brief Writes a reference to the class of @p item to the class name
+     * dictionary of the archive. The class name itself is only written the
+     * first time it is referenced in the archive.
+     * Items of that class can be saved using handle->save(ar, item) afterwards,
+     * without storing an ItemHeader per item.
+     *
+     * @param ar boost oarchive
+     * @param item the class of this item is referenced
+     * @param handle the serialization handle of the class
+     * @return true if successful
+     */
+    template <typename Archive>
+    static bool saveClassReference(Archive& ar, const ItemBase::Ptr& item, HandlePtr& handle)
+    {
+        ClassNameDictionary& dictionary = ar.template get_helper<ClassNameDictionary>(ClassNameDictionary::helperId());
+        const ItemTypeInfoPtr info = getItemTypeInfo(*item);
+        if(!info->serializable)
+            return false;
+        uint64_t index;
+        if(dictionary.insert(info->class_name, index))
+        {
+            dictionary.entries[index].handle = info->handle;
+            saveSizeValue(ar, index);
+            ar << boost::serialization::make_nvp("class_name", info->class_name);
+        }
+        else
+            saveSizeValue(ar, index);
+        handle = dictionary.entries[index].handle;
+        return handle != nullptr;
+    }
+
+    /**
+     * @brief Reads a class reference written by saveClassReference().
+     *
+     * @param ar boost iarchive
+     * @param handle the serialization handle of the referenced class
+     * @return true if a handle is available for the class
+     * @throw std::runtime_error if the reference is invalid
+     */
+    template <typename Archive>
+    static bool loadClassReference(Archive& ar, HandlePtr& handle)
+    {
+        ClassNameDictionary::Entry& entry = readClassReference(ar);
+        handle = resolveClassReference(entry);
+        return handle != nullptr;
+    }
+
+    /**
+     * @brief Reads a class reference written by saveClassReference() without
+     * resolving the serialization handle. I.e. no plugin library is loaded.
+     *
+     * @param ar boost iarchive
+     * @return the dictionary entry of the referenced class. Is valid until
+     *         the next class reference is read.
+     * @throw std::runtime_error if the reference is invalid
+     */
+    template <typename Archive>
+    static ClassNameDictionary::Entry& readClassReference(Archive& ar)
+    {
+        ClassNameDictionary& dictionary = ar.template get_helper<ClassNameDictionary>(ClassNameDictionary::helperId());
+        uint64_t index;
+        loadSizeValue(ar, index);
+        if(index == dictionary.size())
+        {
+            ClassNameDictionary::Entry entry;
+            ar >> boost::serialization::make_nvp("class_name", entry.class_name);
+            dictionary.entries.push_back(entry);
+        }
+        else if(index > dictionary.size())
+            throw std::runtime_error("Invalid class reference in archive");
+        return dictionary.entries[index];
+    }
+
+    /**
+     * @brief Resolves the serialization handle of a dictionary entry once.
+     *
+     * @return the handle or NULL if the class is unknown
+     */
+    static const HandlePtr& resolveClassReference(ClassNameDictionary::Entry& entry)
+    {
+        if(!entry.resolved)
+        {
+            resolveHandle(entry.class_name, entry.handle);
+            entry.resolved = true;
+        }
+        return entry.handle;
+    }
+
     /**
      * @brief Unserializes an abstract item from a boost archive
      *
@@ -152,12 +243,23 @@ public:
     /**
      * @brief Serializes an abstract item to a binary blob
      *
-     * @param binary data
+     * @param binary data, the item is appended to the existing content.
+     *        Reuse the vector to avoid allocations.
      * @param item pointer to the ItemBase class
      * @return true if successful
      */
     static bool saveToBinary(std::vector< uint8_t >& binary, const ItemBase::Ptr& item);
 
+    /**
+     * @brief Serializes an abstract item in binary format to a stream buffer,
+     * e.g. a BinaryChunkedOutputBuffer for scatter-gather output.
+     *
+     * @param buffer the stream buffer
+     * @param item pointer to the ItemBase class
+     * @return true if successful
+     */
+    static bool saveToBinary(std::streambuf& buffer, const ItemBase::Ptr& item);
+
     /**
      * @brief Unserializes an abstract item from a binary blob
      *
@@ -167,6 +269,42 @@ public:
      */
     static bool loadFromBinary(const std::vector< uint8_t >& binary, ItemBase::Ptr& item);
 
+    /**
+     * @brief Unserializes an abstract item from a binary blob
+     *
+     * @param data pointer to the binary data
+     * @param size size of the binary data in bytes
+     * @param item pointer to the ItemBase class
+     * @return true if successful
+     */
+    static bool loadFromBinary(const uint8_t* data, std::size_t size, ItemBase::Ptr& item);
+
+    /**
+     * @brief Serializes items of the same class to a binary blob.
+     * Is used to store length-prefixed item records, which can be skipped
+     * while loading.
+     *
+     * @param binary data, the items are appended to the existing content
+     * @param handle the serialization handle of the class of the items
+     * @param items the items
+     * @return true if successful
+     */
+    static bool saveItemsToBinary(std::vector< uint8_t >& binary, const HandlePtr& handle,
+                                  const std::vector<ItemBase::Ptr>& items);
+
+    /**
+     * @brief Unserializes items that have been stored by saveItemsToBinary()
+     *
+     * @param data pointer to the binary data
+     * @param size size of the binary data in bytes
+     * @param handle the serialization handle of the class of the items
+     * @param count number of items in the binary data
+     * @param items the items are appended to this list
+     * @return true if successful
+     */
+    static bool loadItemsFromBinary(const uint8_t* data, std::size_t size, const HandlePtr& handle,
+                                    uint64_t count, std::vector<ItemBase::Ptr>& items);
+
     /**
      * @brief Returns true if a serialization handle is registered for the given item.
      *
@@ -175,6 +313,16 @@ public:
      */
     static bool isSerializable(const ItemBase::Ptr& item);
 
+    /**
+     * @brief Returns the serialization information of the type of @p item.
+     * The result is cached per type. Types that are not serializable are
+     * cached as well and only resolved again after new serialization handles
+     * have been registered. I.e. plugin libraries are not searched on every
+     * call for types that are not registered.
+     * This method is thread-safe.
+     */
+    static ItemTypeInfoPtr getItemTypeInfo(const ItemBase& item);
+
     /**
      * @brief Returns a reference to the static HandleMap object.
      *
@@ -210,9 +358,39 @@ public:
      */
     static bool getHandle(const std::string& plugin_name, HandlePtr& handle);
 
+    /**
+     * @brief Returns the SerializationHandle for a certain inherited class.
+     * Tries to load the plugin library of the class if necessary.
+     *
+     * @param class_name name of the inherited class
+     * @param handle pointer to the SerializationHandle
+     * @return true of successful
+     */
+    static bool resolveHandle(const std::string& class_name, HandlePtr& handle);
+
 private:
+    /**
+     * @brief Guards the HandleMap.
+     * Plugin libraries register their handles while being loaded by the
+     * ClassLoader, which holds its index mutex. Thus this mutex must never
+     * be held while calling into the ClassLoader.
+     */
+    static std::recursive_mutex& getHandleMutex();
+
+    /** Resolves the serialization information of the type of @p item */
+    static boost::shared_ptr<ItemTypeInfo> resolveItemType(const ItemBase& item);
+
+    /**
+     * @brief Counts the handle registrations.
+     * Is used to invalidate cached negative results.
+     */
+    static std::atomic<uint64_t>& getHandleGeneration();
+
     static bool loadPluginLibrary(const std::string& class_name);
 
+    /** Loads the plugin library that provides the item for @p embedded_type */
+    static bool loadPluginLibraryFor(const std::type_info& embedded_type);
+
     static bool loadAllPluginLibraries();
 };
 
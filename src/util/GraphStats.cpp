@@ -0,0 +1,283 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <envire_core/util/GraphStats.hpp>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace envire { namespace core
+{
+
+namespace
+{
+    constexpr std::size_t NUM_COUNTERS = static_cast<std::size_t>(GraphCounter::COUNT);
+    constexpr std::size_t NUM_TIMERS = static_cast<std::size_t>(GraphTimer::COUNT);
+
+    /**The counters of one thread. Only the owning thread writes, thus
+     * relaxed loads and stores are sufficient and no atomic read-modify-write
+     * is needed. Other threads only read them in snapshot(). */
+    struct ThreadStats
+    {
+        struct Histogram
+        {
+            std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKETS> buckets;
+            std::atomic<uint64_t> count;
+            std::atomic<uint64_t> totalNs;
+            std::atomic<uint64_t> maxNs;
+        };
+
+        std::array<std::atomic<uint64_t>, NUM_COUNTERS> counters;
+        std::array<Histogram, NUM_TIMERS> timers;
+
+        ThreadStats() { clear(); }
+
+        void clear()
+        {
+            for(auto& counter : counters)
+                counter.store(0, std::memory_order_relaxed);
+            for(Histogram& timer : timers)
+            {
+                for(auto& bucket : timer.buckets)
+                    bucket.store(0, std::memory_order_relaxed);
+                timer.count.store(0, std::memory_order_relaxed);
+                timer.totalNs.store(0, std::memory_order_relaxed);
+                timer.maxNs.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    inline void increment(std::atomic<uint64_t>& value, const uint64_t n)
+    {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /**Keeps track of the counters of all threads */
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<ThreadStats*> threads;
+        /**Counters of the threads that already terminated */
+        ThreadStats retired;
+    };
+
+    Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    void accumulate(const ThreadStats& stats, std::array<uint64_t, NUM_COUNTERS>& counters,
+                    std::array<LatencyHistogram, NUM_TIMERS>& timers)
+    {
+        for(std::size_t i = 0; i < NUM_COUNTERS; ++i)
+            counters[i] += stats.counters[i].load(std::memory_order_relaxed);
+        for(std::size_t i = 0; i < NUM_TIMERS; ++i)
+        {
+            LatencyHistogram& histogram = timers[i];
+            const ThreadStats::Histogram& timer = stats.timers[i];
+            for(std::size_t b = 0; b < LatencyHistogram::BUCKETS; ++b)
+                histogram.buckets[b] += timer.buckets[b].load(std::memory_order_relaxed);
+            histogram.count += timer.count.load(std::memory_order_relaxed);
+            histogram.totalNs += timer.totalNs.load(std::memory_order_relaxed);
+            histogram.maxNs = std::max(histogram.maxNs, timer.maxNs.load(std::memory_order_relaxed));
+        }
+    }
+
+    /**Registers the counters of a thread on construction and moves them to
+     * the retired counters when the thread terminates */
+    struct ThreadStatsHolder
+    {
+        ThreadStats stats;
+
+        ThreadStatsHolder()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.threads.push_back(&stats);
+        }
+
+        ~ThreadStatsHolder()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.threads.erase(std::remove(registry.threads.begin(), registry.threads.end(), &stats),
+                                   registry.threads.end());
+            ThreadStats& retired = registry.retired;
+            for(std::size_t i = 0; i < NUM_COUNTERS; ++i)
+                increment(retired.counters[i], stats.counters[i].load(std::memory_order_relaxed));
+            for(std::size_t i = 0; i < NUM_TIMERS; ++i)
+            {
+                for(std::size_t b = 0; b < LatencyHistogram::BUCKETS; ++b)
+                    increment(retired.timers[i].buckets[b], stats.timers[i].buckets[b].load(std::memory_order_relaxed));
+                increment(retired.timers[i].count, stats.timers[i].count.load(std::memory_order_relaxed));
+                increment(retired.timers[i].totalNs, stats.timers[i].totalNs.load(std::memory_order_relaxed));
+                retired.timers[i].maxNs.store(std::max(retired.timers[i].maxNs.load(std::memory_order_relaxed),
+                                                       stats.timers[i].maxNs.load(std::memory_order_relaxed)),
+                                              std::memory_order_relaxed);
+            }
+        }
+    };
+
+    ThreadStats& getThreadStats()
+    {
+        static thread_local ThreadStatsHolder holder;
+        return holder.stats;
+    }
+}
+
+LatencyHistogram::LatencyHistogram() : count(0), totalNs(0), maxNs(0)
+{
+    buckets.fill(0);
+}
+
+double LatencyHistogram::meanNs() const
+{
+    return count > 0 ? double(totalNs) / count : 0.0;
+}
+
+uint64_t LatencyHistogram::percentileNs(const double p) const
+{
+    if(count == 0)
+        return 0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * count + 0.5));
+    uint64_t seen = 0;
+    for(std::size_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if(seen >= rank)
+            return std::min<uint64_t>(maxNs, i == 0 ? 0 : (uint64_t(1) << i) - 1);
+    }
+    return maxNs;
+}
+
+std::size_t LatencyHistogram::bucketOf(const uint64_t ns)
+{
+    std::size_t bucket = 0;
+    for(uint64_t v = ns; v != 0; v >>= 1)
+        ++bucket;
+    return std::min(bucket, BUCKETS - 1);
+}
+
+GraphStats::GraphStats()
+{
+    counters.fill(0);
+}
+
+bool GraphStats::isEnabled()
+{
+#ifdef CMAKE_ENABLE_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+GraphStats GraphStats::snapshot()
+{
+    GraphStats result;
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    accumulate(registry.retired, result.counters, result.timers);
+    for(const ThreadStats* stats : registry.threads)
+        accumulate(*stats, result.counters, result.timers);
+    return result;
+}
+
+void GraphStats::reset()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired.clear();
+    for(ThreadStats* stats : registry.threads)
+        stats->clear();
+}
+
+uint64_t GraphStats::get(const GraphCounter counter) const
+{
+    return counters.at(static_cast<std::size_t>(counter));
+}
+
+const LatencyHistogram& GraphStats::get(const GraphTimer timer) const
+{
+    return timers.at(static_cast<std::size_t>(timer));
+}
+
+const char* GraphStats::getName(const GraphCounter counter)
+{
+    switch(counter)
+    {
+        case GraphCounter::TRANSFORM_BFS: return "transform_bfs";
+        case GraphCounter::TRANSFORM_BFS_VERTICES: return "transform_bfs_vertices";
+        case GraphCounter::PATH_BFS: return "path_bfs";
+        case GraphCounter::PATH_BFS_VERTICES: return "path_bfs_vertices";
+        case GraphCounter::TREE_VIEW_EDGE_UPDATES: return "tree_view_edge_updates";
+        case GraphCounter::TREE_VIEW_FILTERED_BFS: return "tree_view_filtered_bfs";
+        case GraphCounter::TREE_VIEW_REBUILDS: return "tree_view_rebuilds";
+        case GraphCounter::TREE_VIEW_REMOVED_VERTICES: return "tree_view_removed_vertices";
+        case GraphCounter::TREE_VIEW_REATTACHED_VERTICES: return "tree_view_reattached_vertices";
+        case GraphCounter::FLAT_TREE_VIEW_REMOVED_VERTICES: return "flat_tree_view_removed_vertices";
+        case GraphCounter::FLAT_TREE_VIEW_REATTACHED_VERTICES: return "flat_tree_view_reattached_vertices";
+        case GraphCounter::NOTIFY_CALLS: return "notify_calls";
+        case GraphCounter::NOTIFY_SUBSCRIBERS: return "notify_subscribers";
+        case GraphCounter::CURRENT_STATE_PUBLISHED: return "current_state_published";
+        case GraphCounter::CURRENT_STATE_EVENTS: return "current_state_events";
+        case GraphCounter::CURRENT_STATE_ITEMS: return "current_state_items";
+        default: return "unknown";
+    }
+}
+
+const char* GraphStats::getName(const GraphTimer timer)
+{
+    switch(timer)
+    {
+        case GraphTimer::GET_TRANSFORM: return "get_transform";
+        case GraphTimer::ADD_EDGE_TO_TREE_VIEWS: return "add_edge_to_tree_views";
+        case GraphTimer::TREE_VIEW_REMOVE_EDGE: return "tree_view_remove_edge";
+        case GraphTimer::FLAT_TREE_VIEW_REMOVE_EDGE: return "flat_tree_view_remove_edge";
+        case GraphTimer::NOTIFY: return "notify";
+        case GraphTimer::PUBLISH_CURRENT_STATE: return "publish_current_state";
+        default: return "unknown";
+    }
+}
+
+void GraphStats::add(const GraphCounter counter, const uint64_t n)
+{
+    increment(getThreadStats().counters[static_cast<std::size_t>(counter)], n);
+}
+
+void GraphStats::record(const GraphTimer timer, const uint64_t ns)
+{
+    ThreadStats::Histogram& histogram = getThreadStats().timers[static_cast<std::size_t>(timer)];
+    increment(histogram.buckets[LatencyHistogram::bucketOf(ns)], 1);
+    increment(histogram.count, 1);
+    increment(histogram.totalNs, ns);
+    if(ns > histogram.maxNs.load(std::memory_order_relaxed))
+        histogram.maxNs.store(ns, std::memory_order_relaxed);
+}
+
+}}
@@ -0,0 +1,164 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace envire { namespace core
+{
+    /**Counters of the instrumented hot paths */
+    enum class GraphCounter : std::size_t
+    {
+        TRANSFORM_BFS,              /**< getTransform() calls that had to search the graph */
+        TRANSFORM_BFS_VERTICES,     /**< vertices discovered by those searches */
+        PATH_BFS,                   /**< getFrames()/getPath() searches */
+        PATH_BFS_VERTICES,          /**< vertices discovered by those searches */
+        TREE_VIEW_EDGE_UPDATES,     /**< edges added to subscribed tree views */
+        TREE_VIEW_FILTERED_BFS,     /**< edge additions that needed a filtered bfs to add a sub-tree */
+        TREE_VIEW_REBUILDS,         /**< tree views rebuilt from scratch */
+        TREE_VIEW_REMOVED_VERTICES, /**< vertices removed by TreeView::removeEdge() */
+        TREE_VIEW_REATTACHED_VERTICES, /**< removed vertices that were re-attached through a cross-edge */
+        FLAT_TREE_VIEW_REMOVED_VERTICES, /**< vertices removed by FlatTreeView::removeEdge() */
+        FLAT_TREE_VIEW_REATTACHED_VERTICES, /**< the same for FlatTreeView */
+        NOTIFY_CALLS,               /**< GraphEventPublisher::notify() calls */
+        NOTIFY_SUBSCRIBERS,         /**< subscribers reached by those calls */
+        CURRENT_STATE_PUBLISHED,    /**< subscriptions that requested the current state */
+        CURRENT_STATE_EVENTS,       /**< events sent to publish or unpublish the current state */
+        CURRENT_STATE_ITEMS,        /**< items replayed by EnvireGraph::publishCurrentState() */
+        COUNT
+    };
+
+    /**Timed hot paths */
+    enum class GraphTimer : std::size_t
+    {
+        GET_TRANSFORM,              /**< TransformGraph::getTransform() without tree view */
+        ADD_EDGE_TO_TREE_VIEWS,     /**< updating the subscribed tree views after add_edge() */
+        TREE_VIEW_REMOVE_EDGE,      /**< TreeView::removeEdge() */
+        FLAT_TREE_VIEW_REMOVE_EDGE, /**< FlatTreeView::removeEdge() */
+        NOTIFY,                     /**< GraphEventPublisher::notify() */
+        PUBLISH_CURRENT_STATE,      /**< publishing the current state to a new subscriber */
+        COUNT
+    };
+
+    /**Latency histogram with logarithmic buckets.
+     * Bucket i counts the durations in [2^(i-1), 2^i) ns, bucket 0 counts 0 ns. */
+    struct LatencyHistogram
+    {
+        static constexpr std::size_t BUCKETS = 40;
+
+        std::array<uint64_t, BUCKETS> buckets;
+        uint64_t count;
+        uint64_t totalNs;
+        uint64_t maxNs;
+
+        LatencyHistogram();
+
+        double meanNs() const;
+
+        /** @return the upper bound of the bucket that contains the
+         *          percentile @p p (0..1), i.e. at most twice the real value */
+        uint64_t percentileNs(const double p) const;
+
+        static std::size_t bucketOf(const uint64_t ns);
+    };
+
+    /**Snapshot of the instrumentation counters and latency histograms of the
+     * graph hot paths (Graph, TransformGraph, TreeView and GraphEventPublisher).
+     *
+     * The instrumentation is compiled in if CMAKE_ENABLE_INSTRUMENTATION is
+     * defined (cmake option ENABLE_INSTRUMENTATION). Otherwise the macros
+     * below expand to nothing and all snapshots are zero.
+     * Each thread records into its own counters, snapshot() sums up the
+     * counters of all threads including threads that already terminated. */
+    class GraphStats
+    {
+    public:
+        GraphStats();
+
+        /** @return true if the instrumentation has been compiled in */
+        static bool isEnabled();
+
+        /** @return the sum of the counters of all threads */
+        static GraphStats snapshot();
+
+        /**Resets the counters of all threads.
+         * Values recorded concurrently by other threads might get lost. */
+        static void reset();
+
+        uint64_t get(const GraphCounter counter) const;
+        const LatencyHistogram& get(const GraphTimer timer) const;
+
+        static const char* getName(const GraphCounter counter);
+        static const char* getName(const GraphTimer timer);
+
+        /**Adds @p n to @p counter of the current thread. Use ENVIRE_STATS_COUNT instead. */
+        static void add(const GraphCounter counter, const uint64_t n);
+
+        /**Records a duration of @p timer in the current thread. Use ENVIRE_STATS_TIMER instead. */
+        static void record(const GraphTimer timer, const uint64_t ns);
+
+    private:
+        std::array<uint64_t, static_cast<std::size_t>(GraphCounter::COUNT)> counters;
+        std::array<LatencyHistogram, static_cast<std::size_t>(GraphTimer::COUNT)> timers;
+    };
+
+    /**Records the lifetime of the object in a timer */
+    class ScopedGraphTimer
+    {
+    public:
+        explicit ScopedGraphTimer(const GraphTimer timer) :
+            timer(timer), start(std::chrono::steady_clock::now()) {}
+
+        ~ScopedGraphTimer()
+        {
+            const auto duration = std::chrono::steady_clock::now() - start;
+            GraphStats::record(timer, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+        }
+
+    private:
+        const GraphTimer timer;
+        const std::chrono::steady_clock::time_point start;
+    };
+}}
+
+#define ENVIRE_STATS_CONCAT_IMPL(a, b) a##b
+#define ENVIRE_STATS_CONCAT(a, b) ENVIRE_STATS_CONCAT_IMPL(a, b)
+
+#ifdef CMAKE_ENABLE_INSTRUMENTATION
+    /**Adds @p n to the GraphCounter @p counter. @p n is not evaluated if the instrumentation is disabled. */
+    #define ENVIRE_STATS_COUNT(counter, n) \
+        ::envire::core::GraphStats::add(::envire::core::GraphCounter::counter, (n))
+    /**Records the time until the end of the current scope in the GraphTimer @p timer */
+    #define ENVIRE_STATS_TIMER(timer) \
+        ::envire::core::ScopedGraphTimer ENVIRE_STATS_CONCAT(envire_stats_timer_, __LINE__)(::envire::core::GraphTimer::timer)
+#else
+    #define ENVIRE_STATS_COUNT(counter, n) do {} while(false)
+    #define ENVIRE_STATS_TIMER(timer) do {} while(false)
+#endif
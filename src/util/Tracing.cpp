@@ -0,0 +1,294 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <envire_core/util/Tracing.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+namespace envire { namespace core
+{
+
+std::atomic<bool> Tracer::enabled(false);
+constexpr std::size_t Tracer::MAX_EVENTS_PER_THREAD;
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+        std::string args;
+    };
+
+    struct Chunk
+    {
+        static constexpr std::size_t SIZE = 1024;
+        TraceEvent events[SIZE];
+        std::atomic<Chunk*> next;
+        Chunk() : next(nullptr) {}
+    };
+    constexpr std::size_t Chunk::SIZE;
+
+    /**Append-only event buffer of one thread.
+     * Only the owning thread appends. An event is published by increasing
+     * @c committed (release), readers only access the committed events. */
+    struct ThreadBuffer
+    {
+        const uint32_t tid;
+        Chunk* const first;
+        /**Last chunk, only accessed by the owning thread */
+        Chunk* last;
+        std::atomic<std::size_t> committed;
+        std::atomic<std::size_t> dropped;
+
+        explicit ThreadBuffer(const uint32_t tid) :
+            tid(tid), first(new Chunk()), last(first), committed(0), dropped(0) {}
+
+        ~ThreadBuffer()
+        {
+            freeChunks(first);
+        }
+
+        void append(const char* name, const int64_t begin, const int64_t end, std::string&& args)
+        {
+            const std::size_t index = committed.load(std::memory_order_relaxed);
+            if(index >= Tracer::MAX_EVENTS_PER_THREAD)
+            {
+                dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+            if(index > 0 && index % Chunk::SIZE == 0)
+            {
+                Chunk* chunk = new Chunk();
+                last->next.store(chunk, std::memory_order_release);
+                last = chunk;
+            }
+            TraceEvent& event = last->events[index % Chunk::SIZE];
+            event.name = name;
+            event.begin = begin;
+            event.end = end;
+            event.args = std::move(args);
+            committed.store(index + 1, std::memory_order_release);
+        }
+
+        template <class FUNC>
+        void forEach(FUNC func) const
+        {
+            const std::size_t count = committed.load(std::memory_order_acquire);
+            const Chunk* chunk = first;
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                if(i > 0 && i % Chunk::SIZE == 0)
+                    chunk = chunk->next.load(std::memory_order_acquire);
+                func(chunk->events[i % Chunk::SIZE]);
+            }
+        }
+
+        /**Only allowed while the owning thread does not record */
+        void clear()
+        {
+            freeChunks(first->next.exchange(nullptr));
+            last = first;
+            committed.store(0, std::memory_order_relaxed);
+            dropped.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        static void freeChunks(Chunk* chunk)
+        {
+            while(chunk != nullptr)
+            {
+                Chunk* next = chunk->next.load(std::memory_order_relaxed);
+                delete chunk;
+                chunk = next;
+            }
+        }
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        /**Buffers of all threads, including the threads that terminated */
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        uint32_t nextTid = 1;
+    };
+
+    Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadBuffer& getThreadBuffer()
+    {
+        static thread_local std::shared_ptr<ThreadBuffer> buffer;
+        if(!buffer)
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            buffer = std::make_shared<ThreadBuffer>(registry.nextTid++);
+            registry.buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    void writeJsonString(std::string& out, const std::string& value)
+    {
+        out += '"';
+        for(const char c : value)
+        {
+            switch(c)
+            {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                case '\r': out += "\\r"; break;
+                default:
+                    if(static_cast<unsigned char>(c) < 0x20)
+                    {
+                        char escaped[7];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        out += escaped;
+                    }
+                    else
+                        out += c;
+            }
+        }
+        out += '"';
+    }
+
+    void appendKey(std::string& args, const char* key)
+    {
+        if(!args.empty())
+            args += ',';
+        writeJsonString(args, key);
+        args += ':';
+    }
+}
+
+void Tracer::setEnabled(const bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Tracer::record(const char* name, const int64_t beginNs, const int64_t endNs,
+                    std::string&& args)
+{
+    getThreadBuffer().append(name, beginNs, endNs, std::move(args));
+}
+
+std::size_t Tracer::getEventCount()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::size_t count = 0;
+    for(const auto& buffer : registry.buffers)
+        count += buffer->committed.load(std::memory_order_acquire);
+    return count;
+}
+
+std::size_t Tracer::getDroppedEventCount()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::size_t count = 0;
+    for(const auto& buffer : registry.buffers)
+        count += buffer->dropped.load(std::memory_order_relaxed);
+    return count;
+}
+
+void Tracer::dumpChromeTrace(std::ostream& stream)
+{
+    const pid_t pid = getpid();
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    stream << "{\"traceEvents\":[";
+    bool firstEvent = true;
+    stream << std::fixed << std::setprecision(3);
+    for(const auto& buffer : registry.buffers)
+    {
+        buffer->forEach([&](const TraceEvent& event)
+        {
+            if(!firstEvent)
+                stream << ",";
+            firstEvent = false;
+            //complete events ("X") contain the begin and the duration in microseconds
+            stream << "\n{\"name\":\"" << event.name << "\",\"cat\":\"envire\",\"ph\":\"X\""
+                   << ",\"ts\":" << event.begin / 1000.0
+                   << ",\"dur\":" << (event.end - event.begin) / 1000.0
+                   << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+                   << ",\"args\":{" << event.args << "}}";
+        });
+    }
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void Tracer::dumpChromeTrace(const std::string& file)
+{
+    std::ofstream stream;
+    stream.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    stream.open(file); //may throw
+    dumpChromeTrace(stream);
+    stream.close();
+}
+
+void Tracer::clear()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<std::shared_ptr<ThreadBuffer>> alive;
+    for(const auto& buffer : registry.buffers)
+    {
+        //the registry holds the only reference to buffers of terminated threads
+        if(buffer.use_count() > 1)
+        {
+            buffer->clear();
+            alive.push_back(buffer);
+        }
+    }
+    registry.buffers.swap(alive);
+}
+
+void TraceScope::addArg(const char* key, const std::string& value)
+{
+    appendKey(args, key);
+    writeJsonString(args, value);
+}
+
+void TraceScope::addArg(const char* key, const int64_t value)
+{
+    appendKey(args, key);
+    args += std::to_string(value);
+}
+
+}}
@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace envire { namespace core
+{
+    /**Records trace events of graph and serialization operations and writes
+     * them in the Chrome trace event format (chrome://tracing, perfetto).
+     *
+     * Tracing is disabled by default and can be enabled at runtime. When
+     * disabled a trace point only costs a relaxed atomic load.
+     * Each thread records into its own append-only buffer, recording does
+     * not take any locks. The buffer of a thread is kept after the thread
+     * terminated, until clear() is called. */
+    class Tracer
+    {
+    public:
+        /**Maximum number of events per thread, further events are dropped */
+        static constexpr std::size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+        static bool isEnabled()
+        {
+            return enabled.load(std::memory_order_relaxed);
+        }
+
+        static void setEnabled(const bool enable);
+
+        /**Records a complete event.
+         * @param name has to be a string literal, it is not copied
+         * @param args the content of a json object, e.g. "frame":"a","items":3 */
+        static void record(const char* name, const int64_t beginNs, const int64_t endNs,
+                           std::string&& args);
+
+        /** @return the number of recorded events of all threads */
+        static std::size_t getEventCount();
+
+        /** @return the number of events that have been dropped because a thread buffer was full */
+        static std::size_t getDroppedEventCount();
+
+        /**Writes all recorded events as Chrome trace json to @p stream.
+         * Can be called while other threads record events, events that are
+         * recorded concurrently might be missing. */
+        static void dumpChromeTrace(std::ostream& stream);
+
+        /**Writes all recorded events as Chrome trace json to @p file.
+         * @throw std::ios_base::failure if the file operation failed*/
+        static void dumpChromeTrace(const std::string& file);
+
+        /**Removes all recorded events.
+         * Must not be called while other threads record events. */
+        static void clear();
+
+        /** @return the timestamp used for the trace events in ns */
+        static int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        static std::atomic<bool> enabled;
+    };
+
+    /**Records a trace event from construction to destruction if tracing is enabled.
+     * Use the ENVIRE_TRACE_SCOPE and ENVIRE_TRACE_ARG macros. */
+    class TraceScope
+    {
+    public:
+        /** @param name has to be a string literal */
+        explicit TraceScope(const char* name) :
+            name(name), active(Tracer::isEnabled()), begin(active ? Tracer::now() : 0) {}
+
+        ~TraceScope()
+        {
+            if(active)
+                Tracer::record(name, begin, Tracer::now(), std::move(args));
+        }
+
+        bool isActive() const { return active; }
+
+        /**Adds an argument to the event. Only call if isActive() */
+        void addArg(const char* key, const std::string& value);
+        void addArg(const char* key, const int64_t value);
+
+    private:
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+        const char* name;
+        const bool active;
+        const int64_t begin;
+        std::string args;
+    };
+}}
+
+/**Traces the current scope as event @p name. Only one trace scope per block is possible. */
+#define ENVIRE_TRACE_SCOPE(name) \
+    ::envire::core::TraceScope envire_trace_scope(name)
+
+/**Adds an argument to the trace scope of the current block.
+ * @p value is only evaluated if tracing is enabled. */
+#define ENVIRE_TRACE_ARG(key, value) \
+    do { if(envire_trace_scope.isActive()) envire_trace_scope.addArg(key, value); } while(false)
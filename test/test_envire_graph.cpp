@@ -813,3 +813,95 @@ BOOST_AUTO_TEST_CASE(bfs_visitor_test)
     BOOST_CHECK_NO_THROW(graph.getFrames(a, a));
 }
 
+
+BOOST_AUTO_TEST_CASE(envire_graph_item_store_test)
+{
+    FrameId a = "frame_a";
+    EnvireGraph graph;
+    graph.addFrame(a);
+    
+    BOOST_CHECK(!graph.hasItemStore<int>(a));
+    BOOST_CHECK_THROW(graph.getItemStore<int>(a), NoItemsOfTypeInFrameException);
+    BOOST_CHECK_THROW(graph.enableItemStore<int>("unknown"), UnknownFrameException);
+    
+    graph.enableItemStore<int>(a, 100);
+    BOOST_CHECK(graph.hasItemStore<int>(a));
+    BOOST_CHECK(graph.getItemStore<int>(a).empty());
+    
+    for(int i = 0; i < 10; ++i)
+    {
+        graph.addItemToStore<int>(a, i);
+    }
+    Item<int> item(42);
+    graph.addItemToStore(a, item);
+    graph.addItemToFrame(a, ItemBase::Ptr(new Item<int>(21)));
+    
+    const ItemStore<int>& store = graph.getItemStore<int>(a);
+    BOOST_CHECK(store.size() == 11);
+    BOOST_CHECK(graph.getItemCount<Item<int>>(a) == 12);
+    BOOST_CHECK(graph.getTotalItemCount(a) == 12);
+    int i = 0;
+    for(const ItemStore<int>::Entry& entry : store)
+    {
+        if(i < 10)
+            BOOST_CHECK(entry.data == i);
+        ++i;
+    }
+    BOOST_CHECK(store[10].data == 42);
+    BOOST_CHECK(store[10].uuid == item.getID());
+    BOOST_CHECK(store[0].uuid != store[1].uuid);
+    
+    Item<int>::Ptr materialized = store.materializeItem(10, a);
+    BOOST_CHECK(materialized->getData() == 42);
+    BOOST_CHECK(materialized->getID() == item.getID());
+    BOOST_CHECK(materialized->getFrame() == a);
+    
+    int visited = 0;
+    graph.visitItems(a, [&visited](const ItemBase::Ptr item) { ++visited; });
+    BOOST_CHECK(visited == 12);
+    
+    //typed access walks the regular items followed by the store entries
+    BOOST_CHECK(graph.containsItems<Item<int>>(a));
+    auto range = graph.getItemData<int>(a);
+    BOOST_CHECK(std::distance(range.first, range.second) == 12);
+    BOOST_CHECK(range.first->getData() == 21);
+    BOOST_CHECK(!range.first->isStoreEntry());
+    auto entryIt = range.first;
+    std::advance(entryIt, 11);
+    BOOST_CHECK(entryIt->isStoreEntry());
+    BOOST_CHECK(entryIt->getID() == item.getID());
+    //writes reach the store
+    entryIt->getData() = 41;
+    BOOST_CHECK(store[10].data == 41);
+    Item<int>::Ptr copied = entryIt->getItem();
+    BOOST_CHECK(copied->getData() == 41);
+    BOOST_CHECK(copied->getFrame() == a);
+    entryIt->getData() = 42;
+    //items of other types do not invalidate the iterators
+    ItemBase::Ptr other(new Item<double>(1.0));
+    graph.addItemToFrame(a, other);
+    BOOST_CHECK(range.first->getData() == 21);
+    graph.removeItemFromFrame(other);
+    
+    //copies do not share the store
+    EnvireGraph copy(graph);
+    copy.addItemToStore<int>(a, 7);
+    BOOST_CHECK(copy.getItemStore<int>(a).size() == 12);
+    BOOST_CHECK(graph.getItemStore<int>(a).size() == 11);
+    
+    EnvireDispatcher d(graph);
+    graph.addItemToStore<int>(a, 43);
+    BOOST_CHECK(d.itemAddedEvents.size() == 1);
+    BOOST_CHECK(boost::dynamic_pointer_cast<Item<int>>(d.itemAddedEvents[0].item)->getData() == 43);
+    
+    auto next = graph.removeItemFromStore<int>(a, store.begin());
+    BOOST_CHECK(d.itemRemovedEvents.size() == 1);
+    BOOST_CHECK(d.itemRemovedEvents[0].item->getFrame() == a);
+    BOOST_CHECK(next.first->data == 1);
+    BOOST_CHECK(store.size() == 11);
+    
+    graph.clearFrame(a);
+    BOOST_CHECK(!graph.hasItemStore<int>(a));
+    BOOST_CHECK(graph.getTotalItemCount(a) == 0);
+    BOOST_CHECK(d.itemRemovedEvents.size() == 13);
+}
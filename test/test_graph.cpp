@@ -37,6 +37,7 @@
 #include <envire_core/graph/GraphDrawing.hpp>
 #include <envire_core/events/GraphEventQueue.hpp>
 #include <vector>
+#include <set>
 #include <string>
  
 using namespace envire::core;
@@ -915,6 +916,63 @@ BOOST_AUTO_TEST_CASE(get_path_test)
     BOOST_CHECK((*path)[3] == D);
 }
 
+struct NestedSearchVisitor : public boost::default_bfs_visitor
+{
+    NestedSearchVisitor(const Gra& graph, std::vector<size_t>& pathSizes) :
+        graph(graph), pathSizes(pathSizes) {}
+
+    template <typename Vertex, typename Graph>
+    void discover_vertex(Vertex v, const Graph&)
+    {
+        //starts a second traversal while the first one is running
+        pathSizes.push_back(graph.getFrames("A", graph.getFrameId(v)).size());
+    }
+
+    const Gra& graph;
+    std::vector<size_t>& pathSizes;
+};
+
+BOOST_AUTO_TEST_CASE(traversal_workspace_test)
+{
+    Gra graph;
+    EdgeProp ep;
+    graph.add_edge("A", "B", ep);
+    graph.add_edge("B", "C", ep);
+    graph.add_edge("C", "D", ep);
+
+    //add and remove frames to leave gaps in the vertex indices
+    for(int i = 0; i < 200; ++i)
+    {
+        const FrameId frame = "tmp_" + boost::lexical_cast<std::string>(i);
+        graph.add_edge("D", frame, ep);
+        graph.disconnectFrame(frame);
+        graph.removeFrame(frame);
+    }
+
+    std::set<size_t> indices;
+    Gra::vertex_iterator it, end;
+    for(boost::tie(it, end) = graph.getVertices(); it != end; ++it)
+    {
+        BOOST_CHECK(graph.getVertexIndex(*it) < graph.getVertexIndexBound());
+        indices.insert(graph.getVertexIndex(*it));
+    }
+    BOOST_CHECK(indices.size() == 4);
+    BOOST_CHECK(graph.getVertexIndexBound() <= 2 * 4 + 64);
+
+    //repeated traversals reuse the workspace
+    for(int i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK(graph.getFrames("A", "D").size() == 4);
+        BOOST_CHECK(graph.getFrames("D", "B").size() == 3);
+    }
+
+    std::vector<size_t> pathSizes;
+    NestedSearchVisitor visitor(graph, pathSizes);
+    graph.breadthFirstSearch(graph.getVertex("A"), boost::visitor(visitor));
+    //getFrames() returns an empty path if origin and target are equal
+    BOOST_CHECK(pathSizes == std::vector<size_t>({0, 2, 3, 4}));
+}
+
 BOOST_AUTO_TEST_CASE(get_path_invalid_frame_test)
 {
     Gra graph;
@@ -980,6 +1038,51 @@ BOOST_AUTO_TEST_CASE(get_updating_path2_test)
 
 
 
+BOOST_AUTO_TEST_CASE(path_registry_test)
+{
+    std::shared_ptr<Path> pathAC;
+    std::shared_ptr<Path> pathDB;
+    {
+        Gra graph;
+        EdgeProp ep;
+        graph.add_edge("A", "B", ep);
+        graph.add_edge("B", "C", ep);
+        graph.add_edge("B", "D", ep);
+
+        pathAC = graph.getPath("A", "C", true);
+        pathDB = graph.getPath("D", "B", true);
+        std::shared_ptr<Path> pathAB = graph.getPath("A", "B", false);
+        {
+            std::shared_ptr<Path> pathCD = graph.getPath("C", "D", true);
+            BOOST_CHECK(graph.getPathRegistry().size() == 3);
+            BOOST_CHECK(graph.getPathRegistry().getPathCount("B", "C") == 2);
+            BOOST_CHECK(graph.getPathRegistry().getPathCount("D", "B") == 2);
+        }
+        //destroyed paths are removed from the registry
+        BOOST_CHECK(graph.getPathRegistry().size() == 2);
+        BOOST_CHECK(graph.getPathRegistry().getPathCount("B", "C") == 1);
+
+        //the direction of the removed edge does not matter
+        graph.remove_edge("B", "A");
+        BOOST_CHECK(pathAC->isDirty());
+        BOOST_CHECK(!pathDB->isDirty());
+        BOOST_CHECK(!pathAB->isDirty());
+        BOOST_CHECK(pathDB->isAutoUpdating());
+
+        //unsubscribed paths are removed from the registry
+        std::shared_ptr<Path> pathBD = graph.getPath("B", "D", true);
+        pathBD->unsubscribe();
+        BOOST_CHECK(!pathBD->isAutoUpdating());
+        BOOST_CHECK(graph.getPathRegistry().size() == 2);
+        graph.remove_edge("B", "D");
+        BOOST_CHECK(!pathBD->isDirty());
+    }
+    //the graph is gone, the paths do not auto update anymore
+    BOOST_CHECK(!pathAC->isAutoUpdating());
+    BOOST_CHECK(!pathAC->isDirty());
+    BOOST_CHECK(!pathDB->isAutoUpdating());
+}
+
 BOOST_AUTO_TEST_CASE(remove_unknown_frame_test)
 {
     FrameId a = "frame_a";
@@ -1515,6 +1618,191 @@ BOOST_AUTO_TEST_CASE(tree_view_remove_edge_cross_edge_test)
 
 
 
+BOOST_AUTO_TEST_CASE(tree_view_remove_edge_reattach_test)
+{
+    using vertex_descriptor = GraphTraits::vertex_descriptor;
+    Gra graph;
+    EdgeProp ep;
+    /*      a
+     *     / \
+     *    b   e
+     *    |   |
+     *    c - d   (c - d is a cross-edge)
+     */
+    graph.add_edge("a", "b", ep);
+    graph.add_edge("a", "e", ep);
+    graph.add_edge("b", "c", ep);
+    graph.add_edge("e", "d", ep);
+    graph.add_edge("c", "d", ep);
+
+    TreeView view;
+    graph.getTree("a", true, &view);
+    FlatTreeView flatView;
+    flatView.track(view);
+
+    const vertex_descriptor b = graph.getVertex("b");
+    const vertex_descriptor c = graph.getVertex("c");
+    const vertex_descriptor d = graph.getVertex("d");
+
+    BOOST_CHECK(view.crossEdges.size() == 1);
+    BOOST_CHECK(view.crossEdgeExists(c, d));
+    BOOST_CHECK(view.crossEdgeExists(d, c));
+
+    std::vector<std::pair<vertex_descriptor, vertex_descriptor>> removed;
+    std::vector<std::pair<vertex_descriptor, vertex_descriptor>> added;
+    view.edgeRemoved.connect([&](vertex_descriptor origin, vertex_descriptor target)
+        {
+            removed.emplace_back(origin, target);
+        });
+    view.edgeAdded.connect([&](vertex_descriptor origin, vertex_descriptor target)
+        {
+            added.emplace_back(origin, target);
+        });
+
+    //b and c are still connected to the tree through the cross-edge c - d
+    graph.remove_edge("a", "b");
+
+    BOOST_CHECK(view.crossEdges.size() == 0);
+    BOOST_CHECK(!view.crossEdgeExists(c, d));
+    BOOST_CHECK(view.getParent(c) == d);
+    BOOST_CHECK(view.getParent(b) == c);
+    BOOST_CHECK(view.tree.size() == 5);
+
+    BOOST_CHECK(removed.size() == 2);
+    BOOST_CHECK(removed[0].second == c);
+    BOOST_CHECK(removed[1].second == b);
+    BOOST_CHECK(added.size() == 2);
+    BOOST_CHECK(added[0] == std::make_pair(d, c));
+    BOOST_CHECK(added[1] == std::make_pair(c, b));
+
+    BOOST_CHECK(flatView.size() == 5);
+    BOOST_CHECK(flatView.getParent(c) == d);
+    BOOST_CHECK(flatView.getParent(b) == c);
+    BOOST_CHECK(flatView.crossEdges.size() == 0);
+
+    //removing a cross-edge from the graph removes it from the view
+    graph.add_edge("a", "c", ep);
+    BOOST_CHECK(view.crossEdges.size() == 1);
+    BOOST_CHECK(flatView.crossEdges.size() == 1);
+    graph.remove_edge("a", "c");
+    BOOST_CHECK(view.crossEdges.size() == 0);
+    BOOST_CHECK(flatView.crossEdges.size() == 0);
+    BOOST_CHECK(view.tree.size() == 5);
+}
+
+BOOST_AUTO_TEST_CASE(flat_tree_view_test)
+{
+    using vertex_descriptor = GraphTraits::vertex_descriptor;
+    Gra graph;
+    EdgeProp ep;
+
+    graph.add_edge("a", "b", ep);
+    graph.add_edge("a", "e", ep);
+    graph.add_edge("b", "c", ep);
+    graph.add_edge("b", "d", ep);
+    graph.add_edge("c", "d", ep);
+
+    const vertex_descriptor a = graph.getVertex("a");
+    const vertex_descriptor b = graph.getVertex("b");
+    const vertex_descriptor c = graph.getVertex("c");
+    const vertex_descriptor d = graph.getVertex("d");
+    const vertex_descriptor e = graph.getVertex("e");
+
+    FlatTreeView view;
+    graph.getTree("a", &view);
+    TreeView tv = graph.getTree("a");
+
+    BOOST_CHECK(view.root == a);
+    BOOST_CHECK(view.size() == 5);
+    BOOST_CHECK(view.crossEdges.size() == 1);
+    for(vertex_descriptor vd : {b, c, d, e})
+    {
+        BOOST_CHECK(view.getParent(vd) == tv.getParent(vd));
+        BOOST_CHECK(view.edgeExists(vd, view.getParent(vd)));
+    }
+    BOOST_CHECK(view.getParent(a) == graph.null_vertex());
+    BOOST_CHECK(view.getDepth(view.getIndex(d)) == 2);
+    BOOST_CHECK(view.getIndex(graph.null_vertex()) == FlatTreeView::NO_INDEX);
+    BOOST_CHECK_THROW(view.getParent(graph.null_vertex()), std::runtime_error);
+
+    //a copy of the TreeView contains the same tree
+    FlatTreeView copy(tv);
+    BOOST_CHECK(copy.size() == 5);
+    BOOST_CHECK(copy.getParent(d) == view.getParent(d));
+
+    std::vector<vertex_descriptor> bfs;
+    view.visitBfs(a, [&](vertex_descriptor node, vertex_descriptor parent)
+    {
+        bfs.push_back(node);
+        BOOST_CHECK(view.getParent(node) == parent);
+    });
+    BOOST_CHECK(bfs.size() == 5);
+    BOOST_CHECK(bfs.front() == a);
+    BOOST_CHECK(bfs.back() == c || bfs.back() == d);
+
+    std::vector<vertex_descriptor> origins;
+    std::vector<vertex_descriptor> targets;
+    view.edgeRemoved.connect([&](vertex_descriptor origin, vertex_descriptor target)
+        {
+            origins.push_back(origin);
+            targets.push_back(target);
+        });
+    view.removeEdge(a, b);
+
+    BOOST_CHECK(view.size() == 2);
+    BOOST_CHECK(view.crossEdges.size() == 0);
+    BOOST_CHECK(!view.vertexExists(b));
+    BOOST_CHECK(!view.vertexExists(c));
+    BOOST_CHECK(!view.vertexExists(d));
+    BOOST_CHECK(view.edgeExists(a, e));
+    BOOST_CHECK(origins.size() == 3);
+    BOOST_CHECK(origins.back() == a);
+    BOOST_CHECK(targets.back() == b);
+    //the remaining indices are still dense
+    BOOST_CHECK(view.getIndex(view.getVertex(0)) == 0);
+    BOOST_CHECK(view.getIndex(view.getVertex(1)) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(flat_tree_view_track_test)
+{
+    using vertex_descriptor = GraphTraits::vertex_descriptor;
+    Gra graph;
+    EdgeProp ep;
+
+    graph.add_edge("a", "b", ep);
+    graph.add_edge("b", "c", ep);
+
+    TreeView tv;
+    graph.getTree("a", true, &tv);
+    FlatTreeView view;
+    view.track(tv);
+
+    int edgesAdded = 0;
+    view.edgeAdded.connect([&](vertex_descriptor, vertex_descriptor) { ++edgesAdded; });
+
+    graph.add_edge("c", "d", ep);
+    graph.add_edge("a", "c", ep);
+
+    const vertex_descriptor a = graph.getVertex("a");
+    const vertex_descriptor c = graph.getVertex("c");
+    const vertex_descriptor d = graph.getVertex("d");
+
+    BOOST_CHECK(edgesAdded == 1);
+    BOOST_CHECK(view.size() == 4);
+    BOOST_CHECK(view.isParent(c, d));
+    BOOST_CHECK(view.crossEdges.size() == 1);
+
+    graph.remove_edge("c", "d");
+    BOOST_CHECK(view.size() == 3);
+    BOOST_CHECK(!view.vertexExists(d));
+    BOOST_CHECK(view.crossEdges.size() == 1);
+
+    view.untrack();
+    graph.add_edge("c", "e", ep);
+    BOOST_CHECK(view.size() == 3);
+    BOOST_CHECK(view.isRoot(a));
+}
+
 BOOST_AUTO_TEST_CASE(publish_current_state_test)
 {
     FrameId a = "frame_a";
@@ -29,6 +29,7 @@
 #include <envire_core/graph/EnvireGraph.hpp>
 #include <envire_core/events/GraphEventDispatcher.hpp>
 #include <envire_core/events/GraphItemEventDispatcher.hpp>
+#include <envire_core/events/GraphEventQueue.hpp>
 #include <envire_core/items/Item.hpp>
 #include <envire_core/graph/GraphDrawing.hpp>
 #include <vector>
@@ -202,3 +203,205 @@ BOOST_AUTO_TEST_CASE(item_changed_callback_autoconnect)
      
 }
 
+
+struct SelfDisconnectingReactor
+{
+    SelfDisconnectingReactor() : calls(0) {}
+    
+    void cb(ItemBase& item)
+    {
+        ++calls;
+        item.disconnectContentsChangedCallback(boost::bind(&SelfDisconnectingReactor::cb, this, _1));
+    }
+    
+    int calls;
+};
+
+BOOST_AUTO_TEST_CASE(item_changed_callback_self_disconnect)
+{
+     Item<string>::Ptr item(new Item<string>("lalala"));
+     BOOST_CHECK(item->getContentsChangedCallbackCount() == 0);
+     //no callbacks connected, should do nothing
+     item->contentsChanged();
+     
+     SelfDisconnectingReactor reactor;
+     ItemContentReactor other;
+     item->connectContentsChangedCallback(boost::bind(&SelfDisconnectingReactor::cb, &reactor, _1));
+     item->connectContentsChangedCallback(boost::bind(&ItemContentReactor::cb, &other, _1));
+     BOOST_CHECK(item->getContentsChangedCallbackCount() == 2);
+     
+     item->contentsChanged();
+     BOOST_CHECK(reactor.calls == 1);
+     //the callback after the disconnected one is still called
+     BOOST_CHECK(other.called);
+     BOOST_CHECK(item->getContentsChangedCallbackCount() == 1);
+     other.reset();
+     
+     item->contentsChanged();
+     BOOST_CHECK(reactor.calls == 1);
+     BOOST_CHECK(other.called);
+     
+     //callbacks are not copied
+     Item<string> copy(*item);
+     BOOST_CHECK(copy.getContentsChangedCallbackCount() == 0);
+}
+
+struct ConnectingReactor
+{
+    ConnectingReactor(ItemContentReactor& other) : other(other), calls(0) {}
+    
+    void cb(ItemBase& item)
+    {
+        ++calls;
+        if(calls == 1)
+            item.connectContentsChangedCallback(boost::bind(&ItemContentReactor::cb, &other, _1));
+        else
+            item.disconnectContentsChangedCallback(boost::bind(&ItemContentReactor::cb, &other, _1));
+    }
+    
+    ItemContentReactor& other;
+    int calls;
+};
+
+BOOST_AUTO_TEST_CASE(item_changed_callback_connect_while_notifying)
+{
+     Item<string>::Ptr item(new Item<string>("lalala"));
+     ItemContentReactor other;
+     ConnectingReactor reactor(other);
+     item->connectContentsChangedCallback(boost::bind(&ConnectingReactor::cb, &reactor, _1));
+     
+     //callbacks that are connected by a callback are called starting with the next call
+     item->contentsChanged();
+     BOOST_CHECK(!other.called);
+     BOOST_CHECK(item->getContentsChangedCallbackCount() == 2);
+     
+     //callbacks that are disconnected before their turn are not called anymore
+     item->contentsChanged();
+     BOOST_CHECK(reactor.calls == 2);
+     BOOST_CHECK(!other.called);
+     BOOST_CHECK(item->getContentsChangedCallbackCount() == 1);
+}
+
+class ItemModifiedQueue : public GraphEventQueue
+{
+public:
+    ItemModifiedQueue(EnvireGraph& graph) : GraphEventQueue(&graph) {}
+    
+    virtual void process(const GraphEvent& event)
+    {
+        events.push_back(event.getType());
+    }
+    
+    vector<GraphEvent::Type> events;
+};
+
+struct ItemModifiedSubscriber : public GraphItemEventDispatcher<Item<string>>
+{
+    ItemModifiedSubscriber(EnvireGraph& graph) : 
+      GraphItemEventDispatcher<Item<string>>(&graph) {}
+
+    virtual void itemModified(const TypedItemModifiedEvent<Item<string>>& event)
+    {
+        frames.push_back(event.frame);
+        data.push_back(event.item->getData());
+    }
+    
+    vector<FrameId> frames;
+    vector<string> data;
+};
+
+BOOST_AUTO_TEST_CASE(item_modified_event)
+{
+     EnvireGraph graph;
+     FrameId frame("frame");
+     graph.addFrame(frame);
+     ItemModifiedSubscriber sub(graph);
+     
+     Item<string>::Ptr item(new Item<string>("lalala"));
+     //not part of the graph yet
+     item->contentsChanged();
+     BOOST_CHECK(sub.data.empty());
+     
+     graph.addItemToFrame(frame, item);
+     item->setData("blub");
+     item->contentsChanged();
+     BOOST_CHECK(sub.data.size() == 1);
+     BOOST_CHECK(sub.data[0] == "blub");
+     BOOST_CHECK(sub.frames[0] == frame);
+     
+     graph.removeItemFromFrame(item);
+     item->contentsChanged();
+     BOOST_CHECK(sub.data.size() == 1);
+     
+     //items outlive the graph
+     Item<string>::Ptr item2(new Item<string>("lalala"));
+     {
+         EnvireGraph graph2;
+         graph2.addFrame(frame);
+         graph2.addItemToFrame(frame, item2);
+         BOOST_CHECK(item2->isObservedBy(&graph2));
+     }
+     BOOST_CHECK(item2->getContentsObserverCount() == 0);
+     item2->contentsChanged();
+}
+
+BOOST_AUTO_TEST_CASE(item_modified_event_shared_item)
+{
+     EnvireGraph graph;
+     FrameId frame("frame");
+     graph.addFrame(frame);
+     ItemModifiedSubscriber sub(graph);
+     Item<string>::Ptr item(new Item<string>("lalala"));
+     graph.addItemToFrame(frame, item);
+     
+     {
+         //the copy shares the item and emits events for it as well
+         EnvireGraph copy(graph);
+         ItemModifiedSubscriber copySub(copy);
+         BOOST_CHECK(item->getContentsObserverCount() == 2);
+         item->contentsChanged();
+         BOOST_CHECK(sub.data.size() == 1);
+         BOOST_CHECK(copySub.data.size() == 1);
+     }
+     //destroying the copy does not detach the original graph
+     BOOST_CHECK(item->isObservedBy(&graph));
+     BOOST_CHECK(item->getContentsObserverCount() == 1);
+     item->contentsChanged();
+     BOOST_CHECK(sub.data.size() == 2);
+     
+     //items that are not owned by a shared_ptr are ignored
+     Item<string> stackItem("blub");
+     stackItem.setFrame(frame);
+     graph.itemContentsChanged(stackItem);
+     BOOST_CHECK(sub.data.size() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(item_modified_event_queue)
+{
+     EnvireGraph graph;
+     FrameId frame("frame");
+     graph.addFrame(frame);
+     Item<string>::Ptr item(new Item<string>("lalala"));
+     Item<string>::Ptr item2(new Item<string>("lalala"));
+     graph.addItemToFrame(frame, item);
+     graph.addItemToFrame(frame, item2);
+     
+     ItemModifiedQueue queue(graph);
+     for(int i = 0; i < 10; ++i)
+     {
+         item->contentsChanged();
+         item2->contentsChanged();
+     }
+     queue.flush();
+     //one event per item
+     BOOST_CHECK(queue.events.size() == 2);
+     BOOST_CHECK(queue.events[0] == GraphEvent::ITEM_MODIFIED);
+     BOOST_CHECK(queue.events[1] == GraphEvent::ITEM_MODIFIED);
+     
+     queue.events.clear();
+     item->contentsChanged();
+     graph.removeItemFromFrame(item);
+     queue.flush();
+     BOOST_CHECK(queue.events.size() == 1);
+     BOOST_CHECK(queue.events[0] == GraphEvent::ITEM_REMOVED_FROM_FRAME);
+}
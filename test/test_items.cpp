@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2015, Deutsches Forschungszentrum für Künstliche Intelligenz GmbH.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <boost/test/unit_test.hpp>
+#include <envire_core/items/Item.hpp>
+#include <envire_core/items/UUIDGenerator.hpp>
+#include <boost/thread.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost_serialization/EigenTypes.hpp>
+#include <Eigen/Core>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+using namespace envire::core;
+using namespace std;
+
+namespace
+{
+    struct UUIDHash
+    {
+        size_t operator()(const boost::uuids::uuid& id) const
+        {
+            return boost::uuids::hash_value(id);
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(uuid_generator_unique_test)
+{
+    const size_t numThreads = 4;
+    const size_t numIds = 10000;
+    vector<vector<boost::uuids::uuid>> ids(numThreads);
+    boost::thread_group threads;
+    for(size_t i = 0; i < numThreads; ++i)
+    {
+        vector<boost::uuids::uuid>& list = ids[i];
+        threads.create_thread([&list, numIds]()
+        {
+            for(size_t j = 0; j < numIds; ++j)
+                list.push_back(Item<int>(42).getID());
+        });
+    }
+    threads.join_all();
+
+    unordered_set<boost::uuids::uuid, UUIDHash> unique;
+    for(const auto& list : ids)
+    {
+        for(const boost::uuids::uuid& id : list)
+        {
+            BOOST_CHECK(id.version() == boost::uuids::uuid::version_random_number_based);
+            BOOST_CHECK(id.variant() == boost::uuids::uuid::variant_rfc_4122);
+            unique.insert(id);
+        }
+    }
+    BOOST_CHECK(unique.size() == numThreads * numIds);
+}
+
+namespace
+{
+    boost::uuids::uuid constantGenerator()
+    {
+        boost::uuids::uuid id = {{1}};
+        return id;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(uuid_generator_set_generator_test)
+{
+    UUIDGenerator::setGenerator(&constantGenerator);
+    BOOST_CHECK(Item<int>().getID() == constantGenerator());
+    UUIDGenerator::setGenerator(&UUIDGenerator::generateRandom);
+    BOOST_CHECK(Item<int>().getID() != Item<int>().getID());
+    UUIDGenerator::setGenerator(NULL);
+    BOOST_CHECK(Item<int>().getID() != Item<int>().getID());
+    BOOST_CHECK(Item<int>().getID() != constantGenerator());
+}
+
+BOOST_AUTO_TEST_CASE(item_create_test)
+{
+    Item<int>::Ptr item = Item<int>::create(42);
+    BOOST_CHECK(item->getData() == 42);
+    BOOST_CHECK(item.use_count() == 1);
+    BOOST_CHECK(Item<std::string>::create()->getData().empty());
+    
+    //freed blocks are reused by the same thread
+    const void* address = item.get();
+    item.reset();
+    Item<int>::Ptr item2 = Item<int>::create(21);
+    BOOST_CHECK(item2.get() == address);
+    BOOST_CHECK(item2->getData() == 21);
+    
+    Item<std::string>* rawItem = new Item<std::string>("bla");
+    delete rawItem;
+    Item<std::string>::Ptr item3(new Item<std::string>("blub"));
+    BOOST_CHECK(item3.get() == rawItem);
+}
+
+BOOST_AUTO_TEST_CASE(item_raw_serialization_test)
+{
+    BOOST_CHECK(IsTriviallySerializable<int>::value);
+    BOOST_CHECK(IsTriviallySerializable<Eigen::Vector3d>::value);
+    BOOST_CHECK(!IsTriviallySerializable<Eigen::VectorXd>::value);
+    BOOST_CHECK(!IsTriviallySerializable<int*>::value);
+    BOOST_CHECK(RawSerialization<std::vector<Eigen::Vector3d>>::value);
+    BOOST_CHECK(!RawSerialization<std::vector<bool>>::value);
+    BOOST_CHECK(!RawSerialization<std::string>::value);
+
+    typedef std::vector<Eigen::Vector3d> Points;
+    Item<Points> cloud;
+    for(int i = 0; i < 1000; ++i)
+        cloud.getData().push_back(Eigen::Vector3d(i, -i, 0.5 * i));
+    cloud.setFrame("cloud_frame");
+
+    std::stringstream stream;
+    {
+        boost::archive::binary_oarchive oa(stream);
+        const Item<Points>& saved = cloud;
+        oa << saved;
+    }
+    // the points are stored as a single block
+    BOOST_CHECK(stream.str().size() < sizeof(Eigen::Vector3d) * 1000 + 256);
+    Item<Points> loaded;
+    {
+        boost::archive::binary_iarchive ia(stream);
+        ia >> loaded;
+    }
+    BOOST_CHECK(loaded.getData() == cloud.getData());
+    BOOST_CHECK(loaded.getFrame() == cloud.getFrame());
+    BOOST_CHECK(loaded.getID() == cloud.getID());
+
+    // text archives use boost serialization
+    Item<std::vector<double>> values;
+    values.getData() = {1.0, 2.5, -3.0};
+    std::stringstream text;
+    {
+        boost::archive::text_oarchive oa(text);
+        const Item<std::vector<double>>& saved = values;
+        oa << saved;
+    }
+    Item<std::vector<double>> loaded_values;
+    {
+        boost::archive::text_iarchive ia(text);
+        ia >> loaded_values;
+    }
+    BOOST_CHECK(loaded_values.getData() == values.getData());
+}
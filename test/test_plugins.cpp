@@ -164,3 +164,40 @@ BOOST_AUTO_TEST_CASE(class_loader_test)
     BOOST_CHECK(string_plugin->getData() == test_string);
     BOOST_CHECK(string_plugin.get() == item_ptr);
 }
+
+BOOST_AUTO_TEST_CASE(class_loader_index_test)
+{
+    ClassLoader* loader = ClassLoader::getInstance();
+    std::vector<std::string> xml_paths;
+    const char* root_folder = std::getenv("AUTOPROJ_CURRENT_ROOT");
+    BOOST_CHECK(root_folder != NULL);
+    std::string root_folder_str(root_folder);
+    root_folder_str += "/envire/envire_core/test";
+    xml_paths.push_back(root_folder_str);
+    loader->clear();
+    loader->overridePluginXmlPaths(xml_paths);
+    loader->reloadXMLPluginFiles();
+
+    // embedded types are resolved using the index
+    std::string class_name;
+    BOOST_CHECK(loader->findEnvireItemClass("Eigen::Vector3d", class_name));
+    BOOST_CHECK(class_name == "envire::core::Item<Eigen::Vector3d>");
+    BOOST_CHECK(!loader->findEnvireItemClass("UnknownType", class_name));
+    // negative results are memoized as well
+    BOOST_CHECK(!loader->findEnvireItemClass("UnknownType", class_name));
+
+    // the library is loaded on first use
+    for(int i = 0; i < 2; ++i)
+    {
+        ItemBase::Ptr item;
+        BOOST_CHECK(loader->createEnvireItemFor("Eigen::Vector3d", item));
+        BOOST_CHECK(item->getClassName(class_name));
+        BOOST_CHECK(class_name == "envire::core::Item<Eigen::Vector3d>");
+    }
+    ItemBase::Ptr unknown;
+    BOOST_CHECK(!loader->createEnvireItemFor("UnknownType", unknown));
+
+    // the index is rebuilt after reloading the plugin xml files
+    loader->reloadXMLPluginFiles();
+    BOOST_CHECK(loader->findEnvireItemClass("Eigen::Vector3d", class_name));
+}
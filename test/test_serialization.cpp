@@ -37,10 +37,12 @@
 #include <fstream>
 
 #include <envire_core/serialization/Serialization.hpp>
+#include <envire_core/serialization/BinaryBufferHelper.hpp>
 #include <envire_core/items/Item.hpp>
 #include <envire_core/plugin/ClassLoader.hpp>
 #include <envire_core/graph/TransformGraph.hpp>
 #include <envire_core/graph/EnvireGraph.hpp>
+#include <envire_core/serialization/GraphJournal.hpp>
 
 using namespace envire::core;
 
@@ -89,6 +91,39 @@ BOOST_AUTO_TEST_CASE(item_serialization_expected_failures)
     BOOST_CHECK(Serialization::load(ia, base_item) == false);
 }
 
+BOOST_AUTO_TEST_CASE(item_type_info_cache)
+{
+    class UnregisteredObject
+    {
+        int i;
+    };
+
+    // the negative result is cached, plugins are not searched again
+    envire::core::ItemBase::Ptr unregistered(new envire::core::Item<UnregisteredObject>);
+    Serialization::ItemTypeInfoPtr info = Serialization::getItemTypeInfo(*unregistered);
+    BOOST_CHECK(!info->serializable);
+    BOOST_CHECK(!Serialization::isSerializable(unregistered));
+    envire::core::ItemBase::Ptr unregistered_2(new envire::core::Item<UnregisteredObject>);
+    BOOST_CHECK(Serialization::getItemTypeInfo(*unregistered_2) == info);
+
+    // registering a new handle invalidates negative results
+    envire::core::ItemBase::Ptr base_plugin;
+    BOOST_CHECK(envire::core::ClassLoader::getInstance()->createEnvireItem("envire::core::Item<Eigen::Vector3d>", base_plugin));
+    boost::shared_ptr<SerializationHandle> handle;
+    BOOST_CHECK(Serialization::getHandle("envire::core::Item<Eigen::Vector3d>", handle));
+    Serialization::registerHandle("envire::core::Item<Eigen::Vector3d>", handle);
+    Serialization::ItemTypeInfoPtr info_2 = Serialization::getItemTypeInfo(*unregistered);
+    BOOST_CHECK(info_2 != info);
+    BOOST_CHECK(!info_2->serializable);
+
+    // positive results are cached
+    Serialization::ItemTypeInfoPtr vector_info = Serialization::getItemTypeInfo(*base_plugin);
+    BOOST_CHECK(vector_info->serializable);
+    BOOST_CHECK(vector_info->class_name == "envire::core::Item<Eigen::Vector3d>");
+    BOOST_CHECK(vector_info->handle != nullptr);
+    BOOST_CHECK(Serialization::getItemTypeInfo(*base_plugin) == vector_info);
+}
+
 BOOST_AUTO_TEST_CASE(vector_plugin_serialization_text)
 {
     // create vector plugin
@@ -172,6 +207,90 @@ BOOST_AUTO_TEST_CASE(vector_plugin_serialization_binary)
     BOOST_CHECK(vector_plugin_3->getTime() == vector_plugin->getTime());
 }
 
+BOOST_AUTO_TEST_CASE(binary_output_buffer)
+{
+    // data is appended to the existing content
+    std::vector<uint8_t> binary(3, 42);
+    {
+        BinaryOutputBuffer buffer(&binary);
+        std::ostream stream(&buffer);
+        for(int i = 0; i < 1000; ++i)
+            stream.put(char(i));
+        const std::string text(5000, 'x');
+        stream.write(text.data(), text.size());
+        BOOST_CHECK(buffer.size() == 6003);
+    }
+    BOOST_CHECK(binary.size() == 6003);
+    BOOST_CHECK(binary[0] == 42 && binary[2] == 42);
+    BOOST_CHECK(binary[3] == 0 && binary[4] == 1 && binary[1002] == uint8_t(999 % 256));
+    BOOST_CHECK(binary[1003] == 'x' && binary.back() == 'x');
+
+    // a reused vector does not allocate
+    const size_t capacity = binary.capacity();
+    const uint8_t* data = binary.data();
+    binary.clear();
+    {
+        BinaryOutputBuffer buffer(&binary);
+        std::ostream stream(&buffer);
+        stream.write("abc", 3);
+    }
+    BOOST_CHECK(binary.size() == 3);
+    BOOST_CHECK(binary.capacity() == capacity);
+    BOOST_CHECK(binary.data() == data);
+
+    // the chunked buffer splits the data without moving it
+    BinaryChunkedOutputBuffer chunked(16);
+    {
+        std::ostream stream(&chunked);
+        for(int i = 0; i < 40; ++i)
+            stream.put(char(i));
+        stream.write("0123456789", 10);
+    }
+    BOOST_CHECK(chunked.size() == 50);
+    std::vector<BinaryChunkedOutputBuffer::Chunk> chunks = chunked.getChunks();
+    BOOST_CHECK(chunks.size() == 4);
+    BOOST_CHECK(chunks[0].size == 16 && chunks[3].size == 2);
+    std::vector<uint8_t> copy;
+    chunked.copyTo(copy);
+    BOOST_CHECK(copy.size() == 50);
+    BOOST_CHECK(copy[17] == 17 && copy[40] == '0' && copy[49] == '9');
+
+    chunked.clear();
+    BOOST_CHECK(chunked.size() == 0);
+    BOOST_CHECK(chunked.getChunks().empty());
+    {
+        std::ostream stream(&chunked);
+        stream.write("abc", 3);
+    }
+    BOOST_CHECK(chunked.getChunks()[0].data == chunks[0].data);
+}
+
+BOOST_AUTO_TEST_CASE(vector_plugin_serialization_chunked)
+{
+    envire::core::ItemBase::Ptr base_plugin;
+    BOOST_CHECK(envire::core::ClassLoader::getInstance()->createEnvireItem("envire::core::Item<Eigen::Vector3d>", base_plugin));
+    Item<Eigen::Vector3d>::Ptr vector_plugin = boost::dynamic_pointer_cast< Item<Eigen::Vector3d> >(base_plugin);
+    vector_plugin->setFrame("body");
+    vector_plugin->getData() << 1.0, -2.0, 3.0;
+
+    std::vector<uint8_t> bin;
+    BOOST_CHECK(Serialization::saveToBinary(bin, base_plugin));
+
+    // a small chunk size forces the archive to span multiple chunks
+    BinaryChunkedOutputBuffer chunked(8);
+    BOOST_CHECK(Serialization::saveToBinary(chunked, base_plugin));
+    BOOST_CHECK(chunked.getChunks().size() > 1);
+    std::vector<uint8_t> copy;
+    chunked.copyTo(copy);
+    BOOST_CHECK(copy == bin);
+
+    envire::core::ItemBase::Ptr loaded;
+    BOOST_CHECK(Serialization::loadFromBinary(copy, loaded));
+    Item<Eigen::Vector3d>::Ptr vector_plugin_2 = boost::dynamic_pointer_cast< Item<Eigen::Vector3d> >(loaded);
+    BOOST_CHECK(vector_plugin_2->getData() == vector_plugin->getData());
+    BOOST_CHECK(vector_plugin_2->getID() == vector_plugin->getID());
+}
+
 BOOST_AUTO_TEST_CASE(test_unkown_plugin_binary_deserialization)
 {
     //Note: This code block can be used to recreate the serialized test files if nessecary
@@ -339,3 +458,350 @@ BOOST_AUTO_TEST_CASE(envire_graph_serialization_binary)
     BOOST_CHECK(tf.transform.translation == tf_2.transform.translation);
     BOOST_CHECK(tf.transform.orientation.matrix() == tf_2.transform.orientation.matrix());
 }
+
+BOOST_AUTO_TEST_CASE(envire_graph_snapshot)
+{
+    FrameId a = "frame_a";
+    FrameId b = "frame_b";
+    FrameId c = "frame_c";
+    EnvireGraph graph;
+    Transform tf;
+    tf.time = base::Time::now();
+    tf.transform.translation << 42, 21, -42;
+    tf.transform.orientation = base::AngleAxisd(0.25, base::Vector3d::UnitX());
+    tf.transform.cov = base::TransformWithCovariance::Covariance::Identity() * 2.0;
+    graph.addTransform(a, b, tf);
+    graph.addFrame(c);
+
+    envire::core::ItemBase::Ptr base_plugin;
+    BOOST_CHECK(envire::core::ClassLoader::getInstance()->createEnvireItem("envire::core::Item<Eigen::Vector3d>", base_plugin));
+    Item<Eigen::Vector3d>::Ptr vector_plugin = boost::dynamic_pointer_cast< Item<Eigen::Vector3d> >(base_plugin);
+    BOOST_CHECK(vector_plugin != NULL);
+    vector_plugin->setTime(base::Time::now());
+    vector_plugin->getData() << 2.0, 3.0, -5.0;
+    graph.addItemToFrame(a, vector_plugin);
+
+    const std::string file = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    graph.saveSnapshot(file);
+
+    EnvireGraph graph_2;
+    graph_2.loadSnapshot(file);
+    BOOST_CHECK_THROW(graph_2.loadSnapshot(file), GraphNotEmptyException);
+
+    BOOST_CHECK(graph.num_edges() == graph_2.num_edges());
+    BOOST_CHECK(graph.num_vertices() == graph_2.num_vertices());
+    BOOST_CHECK(graph_2.containsFrame(c));
+    BOOST_CHECK(graph.graph()[boost::graph_bundle].uuid == graph_2.graph()[boost::graph_bundle].uuid);
+    BOOST_CHECK(graph.graph()[boost::graph_bundle].name == graph_2.graph()[boost::graph_bundle].name);
+
+    Transform tf_2 = graph_2.getTransform(a, b);
+    BOOST_CHECK(tf.time == tf_2.time);
+    BOOST_CHECK(tf.transform.cov == tf_2.transform.cov);
+    BOOST_CHECK(tf.transform.translation == tf_2.transform.translation);
+    BOOST_CHECK(tf.transform.orientation.matrix() == tf_2.transform.orientation.matrix());
+    BOOST_CHECK(graph_2.getTransform(b, a).transform.translation == tf.inverse().transform.translation);
+
+    // items are deserialized on first access
+    const Frame& frame_a = graph_2.graph()[graph_2.getVertex(a)];
+    BOOST_CHECK(frame_a.hasPendingItems());
+    BOOST_CHECK(!graph_2.graph()[graph_2.getVertex(b)].hasPendingItems());
+    BOOST_CHECK(graph_2.getTotalItemCount(a) == 1);
+    BOOST_CHECK(!frame_a.hasPendingItems());
+
+    using Iterator = EnvireGraph::ItemIterator<Item<Eigen::Vector3d>>;
+    Iterator begin, end;
+    boost::tie(begin, end) = graph_2.getItems<Item<Eigen::Vector3d>>(a);
+    BOOST_CHECK(begin != end);
+    BOOST_CHECK(begin->getFrame() == a);
+    BOOST_CHECK(begin->getData() == vector_plugin->getData());
+    BOOST_CHECK(begin->getID() == vector_plugin->getID());
+    BOOST_CHECK(begin->getTime() == vector_plugin->getTime());
+
+    // loaded items are observed by the graph
+    BOOST_CHECK(begin->isObservedBy(&graph_2));
+
+    boost::filesystem::remove(file);
+    EnvireGraph graph_3;
+    BOOST_CHECK_THROW(graph_3.loadSnapshot(file), InvalidSnapshotException);
+}
+
+BOOST_AUTO_TEST_CASE(envire_graph_snapshot_parallel)
+{
+    EnvireGraph graph;
+    const int frameCount = 50;
+    std::vector<Item<Eigen::Vector3d>::Ptr> items;
+    for(int i = 0; i < frameCount; ++i)
+    {
+        const FrameId frame = "frame_" + boost::lexical_cast<std::string>(i);
+        graph.addFrame(frame);
+        if(i > 0)
+        {
+            Transform tf;
+            tf.setIdentity();
+            tf.transform.translation << i, 0, 0;
+            graph.addTransform("frame_0", frame, tf);
+        }
+        for(int j = 0; j < i % 5; ++j)
+        {
+            envire::core::ItemBase::Ptr base_plugin;
+            BOOST_CHECK(envire::core::ClassLoader::getInstance()->createEnvireItem("envire::core::Item<Eigen::Vector3d>", base_plugin));
+            Item<Eigen::Vector3d>::Ptr vector_plugin = boost::dynamic_pointer_cast< Item<Eigen::Vector3d> >(base_plugin);
+            vector_plugin->getData() << i, j, -i;
+            graph.addItemToFrame(frame, vector_plugin);
+            items.push_back(vector_plugin);
+        }
+    }
+
+    const std::string file = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    const std::string file_sequential = file + "_sequential";
+    graph.saveSnapshot(file, 4);
+    graph.saveSnapshot(file_sequential);
+
+    // the parallel mode produces the same file
+    std::ifstream parallel_stream(file, std::ios::binary), sequential_stream(file_sequential, std::ios::binary);
+    std::string parallel_bytes((std::istreambuf_iterator<char>(parallel_stream)), std::istreambuf_iterator<char>());
+    std::string sequential_bytes((std::istreambuf_iterator<char>(sequential_stream)), std::istreambuf_iterator<char>());
+    BOOST_CHECK(parallel_bytes == sequential_bytes);
+
+    EnvireGraph graph_2;
+    graph_2.loadSnapshot(file, 4);
+    BOOST_CHECK(graph_2.num_vertices() == graph.num_vertices());
+    BOOST_CHECK(graph_2.num_edges() == graph.num_edges());
+    for(const Item<Eigen::Vector3d>::Ptr& item : items)
+    {
+        const Frame& frame = graph_2.graph()[graph_2.getVertex(item->getFrame())];
+        BOOST_CHECK(!frame.hasPendingItems());
+        const Frame::ItemList& list = frame.items.at(item->getTypeIndex());
+        bool found = false;
+        for(const ItemBase::Ptr& loaded : list)
+        {
+            if(loaded->getID() == item->getID())
+            {
+                found = true;
+                BOOST_CHECK(boost::static_pointer_cast<Item<Eigen::Vector3d>>(loaded)->getData() == item->getData());
+            }
+        }
+        BOOST_CHECK(found);
+    }
+
+    boost::filesystem::remove(file);
+    boost::filesystem::remove(file_sequential);
+}
+
+static Item<Eigen::Vector3d>::Ptr createVectorItem(const Eigen::Vector3d& data)
+{
+    envire::core::ItemBase::Ptr base_plugin;
+    BOOST_CHECK(envire::core::ClassLoader::getInstance()->createEnvireItem("envire::core::Item<Eigen::Vector3d>", base_plugin));
+    Item<Eigen::Vector3d>::Ptr vector_plugin = boost::dynamic_pointer_cast< Item<Eigen::Vector3d> >(base_plugin);
+    vector_plugin->setData(data);
+    return vector_plugin;
+}
+
+static void checkJournaledGraph(const EnvireGraph& graph, const Item<Eigen::Vector3d>::Ptr& modified)
+{
+    BOOST_CHECK(graph.num_vertices() == 3);
+    BOOST_CHECK(graph.containsFrame("a"));
+    BOOST_CHECK(graph.containsFrame("b"));
+    BOOST_CHECK(graph.containsFrame("d"));
+    BOOST_CHECK(!graph.containsFrame("c"));
+    BOOST_CHECK(graph.getTransform("a", "b").transform.translation == Eigen::Vector3d(4, 5, 6));
+    BOOST_CHECK(!graph.containsEdge("a", "d"));
+    BOOST_CHECK(graph.getItemCount<Item<Eigen::Vector3d>>("a") == 1);
+    BOOST_CHECK(graph.getItemCount<Item<Eigen::Vector3d>>("b") == 0);
+    const Item<Eigen::Vector3d>& item = *graph.getItem<Item<Eigen::Vector3d>>("a");
+    BOOST_CHECK(item.getID() == modified->getID());
+    BOOST_CHECK(item.getData() == Eigen::Vector3d(7, 8, 9));
+}
+
+BOOST_AUTO_TEST_CASE(envire_graph_journal)
+{
+    namespace fs = boost::filesystem;
+    const std::string base = (fs::temp_directory_path() / fs::unique_path()).string();
+    const std::string segment_1 = base + "_1.journal";
+    const std::string segment_2 = base + "_2.journal";
+    const std::string snapshot = base + ".snapshot";
+
+    EnvireGraph graph;
+    Item<Eigen::Vector3d>::Ptr item_a = createVectorItem(Eigen::Vector3d(1, 2, 3));
+    Item<Eigen::Vector3d>::Ptr item_b = createVectorItem(Eigen::Vector3d(3, 2, 1));
+    {
+        GraphJournal journal(&graph, segment_1);
+        Transform tf;
+        tf.setIdentity();
+        graph.addTransform("a", "b", tf);
+        graph.addItemToFrame("a", item_a);
+        graph.addItemToFrame("b", item_b);
+        graph.addFrame("c");
+        BOOST_CHECK(journal.getRecordCount() == 6);
+
+        journal.rotate(segment_2);
+        BOOST_CHECK(journal.getSegment() == segment_2);
+        tf.transform.translation << 4, 5, 6;
+        graph.updateTransform("a", "b", tf);
+        item_a->getData() << 7, 8, 9;
+        item_a->contentsChanged();
+        graph.removeItemFromFrame(item_b);
+        graph.removeFrame("c");
+        graph.addTransform("a", "d", tf);
+        graph.removeTransform("a", "d");
+    }
+    checkJournaledGraph(graph, item_a);
+
+    EnvireGraph replayed;
+    BOOST_CHECK(replayed.replay(segment_1) == 6);
+    BOOST_CHECK(replayed.replay(segment_2) == 7);
+    checkJournaledGraph(replayed, item_a);
+
+    // a partially written record ends the journal
+    {
+        std::ofstream out(segment_2, std::ios::binary | std::ios::app);
+        const uint32_t size = 1000;
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write("garbage", 7);
+    }
+    EnvireGraph truncated;
+    truncated.replay(segment_1);
+    BOOST_CHECK(truncated.replay(segment_2) == 7);
+    checkJournaledGraph(truncated, item_a);
+
+    // fold the first segment into a base snapshot and the second into a new one
+    GraphJournal::compact("", {segment_1}, snapshot);
+    GraphJournal::compact(snapshot, {segment_2}, snapshot);
+    EnvireGraph compacted;
+    compacted.loadSnapshot(snapshot);
+    checkJournaledGraph(compacted, item_a);
+
+    EnvireGraph invalid;
+    BOOST_CHECK_THROW(invalid.replay(snapshot), InvalidJournalException);
+
+    fs::remove(segment_1);
+    fs::remove(segment_2);
+    fs::remove(snapshot);
+}
+
+BOOST_AUTO_TEST_CASE(envire_graph_serialization_class_dictionary)
+{
+    const std::string class_name = "envire::core::Item<Eigen::Vector3d>";
+    const int item_count = 1000;
+    EnvireGraph graph;
+    graph.addFrame("a");
+    graph.addFrame("b");
+    for(int i = 0; i < item_count; ++i)
+        graph.addItemToFrame(i % 2 ? "a" : "b", createVectorItem(Eigen::Vector3d(i, 0, -i)));
+
+    std::stringstream binary_stream;
+    {
+        boost::archive::binary_oarchive oa(binary_stream);
+        oa << graph;
+    }
+    // the class name is stored once in the class dictionary and once per
+    // item record as boost export key, instead of once per item
+    const std::string binary = binary_stream.str();
+    size_t occurrences = 0;
+    for(size_t pos = binary.find(class_name); pos != std::string::npos; pos = binary.find(class_name, pos + 1))
+        ++occurrences;
+    BOOST_CHECK_EQUAL(occurrences, 3);
+
+    EnvireGraph graph_2;
+    {
+        boost::archive::binary_iarchive ia(binary_stream);
+        ia >> graph_2;
+    }
+    BOOST_CHECK(graph_2.getItemCount<Item<Eigen::Vector3d>>("a") == item_count / 2);
+    BOOST_CHECK(graph_2.getItemCount<Item<Eigen::Vector3d>>("b") == item_count / 2);
+    BOOST_CHECK(graph_2.getItem<Item<Eigen::Vector3d>>("a", 2)->getData() == Eigen::Vector3d(5, 0, -5));
+
+    std::stringstream text_stream;
+    {
+        boost::archive::text_oarchive oa(text_stream);
+        oa << graph;
+    }
+    EnvireGraph graph_3;
+    {
+        boost::archive::text_iarchive ia(text_stream);
+        ia >> graph_3;
+    }
+    BOOST_CHECK(graph_3.getItemCount<Item<Eigen::Vector3d>>("b") == item_count / 2);
+    BOOST_CHECK(graph_3.getItem<Item<Eigen::Vector3d>>("b", 3)->getData() == Eigen::Vector3d(6, 0, -6));
+}
+
+BOOST_AUTO_TEST_CASE(envire_graph_partial_load)
+{
+    EnvireGraph graph;
+    Transform tf;
+    tf.transform.translation << 1, 2, 3;
+    tf.transform.orientation.setIdentity();
+    graph.addTransform("a", "b", tf);
+    graph.addTransform("b", "c", tf);
+    graph.addFrame("d");
+    for(const FrameId& frame : {"a", "b", "c", "d"})
+    {
+        graph.addItemToFrame(frame, createVectorItem(Eigen::Vector3d(1, 2, 3)));
+        graph.addItemToFrame(frame, createVectorItem(Eigen::Vector3d(4, 5, 6)));
+    }
+    const std::string file = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    graph.saveToFile(file);
+
+    // everything
+    EnvireGraph graph_all;
+    graph_all.loadFromFile(file);
+    for(const FrameId& frame : {"a", "b", "c", "d"})
+        BOOST_CHECK(graph_all.getItemCount<Item<Eigen::Vector3d>>(frame) == 2);
+    BOOST_CHECK(graph_all.getItem<Item<Eigen::Vector3d>>("c", 1)->getData() == Eigen::Vector3d(4, 5, 6));
+
+    // topology only
+    LoadOptions topology;
+    topology.skipItems = true;
+    EnvireGraph graph_topology;
+    graph_topology.loadFromFile(file, topology);
+    BOOST_CHECK(graph_topology.num_vertices() == 4);
+    BOOST_CHECK(graph_topology.num_edges() == 4);
+    BOOST_CHECK(graph_topology.getTransform("a", "c").transform.translation == Eigen::Vector3d(2, 4, 6));
+    for(const FrameId& frame : {"a", "b", "c", "d"})
+        BOOST_CHECK(graph_topology.getTotalItemCount(frame) == 0);
+
+    // selected frames
+    LoadOptions frames;
+    frames.frames = {"a", "c"};
+    EnvireGraph graph_frames;
+    graph_frames.loadFromFile(file, frames);
+    BOOST_CHECK(graph_frames.num_vertices() == 4);
+    BOOST_CHECK(graph_frames.getItemCount<Item<Eigen::Vector3d>>("a") == 2);
+    BOOST_CHECK(graph_frames.getTotalItemCount("b") == 0);
+    BOOST_CHECK(graph_frames.getItemCount<Item<Eigen::Vector3d>>("c") == 2);
+    BOOST_CHECK(graph_frames.getTotalItemCount("d") == 0);
+
+    // item types
+    LoadOptions whitelist;
+    whitelist.addItemType<Item<Eigen::Vector3d>>();
+    EnvireGraph graph_whitelist;
+    graph_whitelist.loadFromFile(file, whitelist);
+    BOOST_CHECK(graph_whitelist.getItemCount<Item<Eigen::Vector3d>>("d") == 2);
+
+    LoadOptions blacklist = whitelist;
+    blacklist.inclusive = false;
+    EnvireGraph graph_blacklist;
+    graph_blacklist.loadFromFile(file, blacklist);
+    for(const FrameId& frame : {"a", "b", "c", "d"})
+        BOOST_CHECK(graph_blacklist.getTotalItemCount(frame) == 0);
+
+    // subtree below b, one level deep
+    LoadOptions subtree;
+    subtree.subtreeRoot = "b";
+    subtree.subtreeDepth = 1;
+    subtree.frames = {"a", "b", "d"};
+    EnvireGraph graph_subtree;
+    graph_subtree.loadFromFile(file, subtree);
+    BOOST_CHECK(!graph_subtree.graph()[graph_subtree.getVertex("a")].hasPendingItems());
+    BOOST_CHECK(graph_subtree.getItemCount<Item<Eigen::Vector3d>>("a") == 2);
+    BOOST_CHECK(graph_subtree.getItemCount<Item<Eigen::Vector3d>>("b") == 2);
+    BOOST_CHECK(graph_subtree.getTotalItemCount("c") == 0);
+    BOOST_CHECK(graph_subtree.getTotalItemCount("d") == 0);
+    BOOST_CHECK(graph_subtree.getItem<Item<Eigen::Vector3d>>("b", 0)->isObservedBy(&graph_subtree));
+
+    subtree.subtreeRoot = "unknown";
+    EnvireGraph graph_unknown;
+    BOOST_CHECK_THROW(graph_unknown.loadFromFile(file, subtree), UnknownFrameException);
+
+    boost::filesystem::remove(file);
+}
@@ -30,6 +30,7 @@
 #include <boost/lexical_cast.hpp>
 #include <vector>
 #include <string>
+#include <sstream>
 #include <envire_core/graph/GraphDrawing.hpp>
 
 using namespace envire::core;
@@ -347,6 +348,52 @@ BOOST_AUTO_TEST_CASE(get_transform_using_a_tree)
 }
 
 
+BOOST_AUTO_TEST_CASE(get_transform_using_a_flat_tree)
+{
+    Tfg graph;
+    /*       a
+     *      / \
+     *     c   b
+     *   /  \
+     *  d   e
+     *    /  \
+     *   f   g
+     */
+    Transform tf;
+    tf.transform.translation << 1, 2, 1;
+    tf.transform.orientation = base::AngleAxisd(0.25, base::Vector3d::UnitZ());
+
+    graph.addTransform("a", "b", tf);
+    graph.addTransform("a", "c", tf);
+    graph.addTransform("c", "d", tf);
+    graph.addTransform("c", "e", tf);
+    graph.addTransform("e", "f", tf);
+    graph.addTransform("e", "g", tf);
+    graph.addFrame("h");
+
+    FlatTreeView view;
+    graph.getTree("a", &view);
+    BOOST_CHECK(view.size() == 7);
+
+    for(const std::pair<FrameId, FrameId>& p : std::vector<std::pair<FrameId, FrameId>>{
+        {"a", "f"}, {"d", "g"}, {"f", "g"}, {"g", "a"}, {"b", "f"}})
+    {
+        const Transform treeTf = graph.getTransform(p.first, p.second, view);
+        const Transform graphTf = graph.getTransform(p.first, p.second);
+        BOOST_CHECK(treeTf.transform.translation.isApprox(graphTf.transform.translation) ||
+                    (treeTf.transform.translation.isMuchSmallerThan(0.01) &&
+                     graphTf.transform.translation.isMuchSmallerThan(0.01)));
+        BOOST_CHECK(treeTf.transform.orientation.isApprox(graphTf.transform.orientation));
+    }
+
+    /** Identity **/
+    Transform tree_tf_f_f = graph.getTransform("f", "f", view);
+    BOOST_CHECK(tree_tf_f_f.transform.translation.isApprox(Eigen::Vector3d::Zero()));
+
+    //h is not part of the tree
+    BOOST_CHECK_THROW(graph.getTransform("a", "h", view), UnknownTransformException);
+}
+
 BOOST_AUTO_TEST_CASE(get_transform_with_descriptor_between_unconnected_frames_test)
 {
     Tfg graph;
@@ -608,3 +655,70 @@ BOOST_AUTO_TEST_CASE(get_path_transform_dirty_exception_test)
     BOOST_CHECK_THROW(graph.getTransform(path), InvalidPathException);
 }
 
+
+BOOST_AUTO_TEST_CASE(graph_stats_test)
+{
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1,2,3;
+    tf.transform.orientation = Eigen::Quaterniond::Identity();
+    graph.addTransform("A", "B", tf);
+    graph.addTransform("B", "C", tf);
+    graph.addTransform("C", "D", tf);
+
+    TreeView view;
+    graph.getTree("A", true, &view);
+
+    GraphStats::reset();
+    graph.getTransform("A", "D");
+    graph.addTransform("D", "E", tf);
+    graph.getPath("A", "E", false);
+
+    const GraphStats stats = GraphStats::snapshot();
+    if(GraphStats::isEnabled())
+    {
+        BOOST_CHECK_EQUAL(stats.get(GraphCounter::TRANSFORM_BFS), 1);
+        BOOST_CHECK_EQUAL(stats.get(GraphCounter::TRANSFORM_BFS_VERTICES), 4);
+        BOOST_CHECK_EQUAL(stats.get(GraphCounter::PATH_BFS), 1);
+        BOOST_CHECK_EQUAL(stats.get(GraphCounter::TREE_VIEW_EDGE_UPDATES), 1);
+        BOOST_CHECK(stats.get(GraphCounter::NOTIFY_CALLS) > 0);
+        BOOST_CHECK_EQUAL(stats.get(GraphTimer::GET_TRANSFORM).count, 1);
+        BOOST_CHECK(stats.get(GraphTimer::GET_TRANSFORM).percentileNs(1.0) <= stats.get(GraphTimer::GET_TRANSFORM).maxNs);
+    }
+    else
+    {
+        BOOST_CHECK_EQUAL(stats.get(GraphCounter::TRANSFORM_BFS), 0);
+        BOOST_CHECK_EQUAL(stats.get(GraphTimer::GET_TRANSFORM).count, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(tracing_test)
+{
+    Tfg graph;
+    Transform tf;
+    tf.transform.translation << 1,2,3;
+    tf.transform.orientation = Eigen::Quaterniond::Identity();
+
+    Tracer::clear();
+    graph.addTransform("A", "B", tf);
+    BOOST_CHECK_EQUAL(Tracer::getEventCount(), 0);
+
+    Tracer::setEnabled(true);
+    graph.addTransform("B", "C", tf);
+    graph.getTransform("A", "C");
+    Tracer::setEnabled(false);
+    graph.getTransform("A", "C");
+
+    //notify (frame C added), add_edge, notify (edge added) and getTransform
+    BOOST_CHECK_EQUAL(Tracer::getEventCount(), 4);
+    std::stringstream stream;
+    Tracer::dumpChromeTrace(stream);
+    const std::string trace = stream.str();
+    BOOST_CHECK(trace.find("\"name\":\"getTransform\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"origin\":\"A\",\"target\":\"C\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"add_edge\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"ph\":\"X\"") != std::string::npos);
+
+    Tracer::clear();
+    BOOST_CHECK_EQUAL(Tracer::getEventCount(), 0);
+}